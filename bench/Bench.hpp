@@ -0,0 +1,76 @@
+/**
+ * @file Bench.hpp
+ *
+ * @brief Header file with the utilities shared by the benchmarks
+ *
+ * Every benchmark executable is built from a single source file, which
+ * includes this header once. It replaces the global allocation functions to
+ * count the heap allocations made while the benchmarks run.
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _BENCH_HPP_
+#define _BENCH_HPP_
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Heap allocations made so far (number and bytes)
+static std::atomic<size_t> allocations{0};
+static std::atomic<size_t> allocated_bytes{0};
+
+void *operator new(size_t size)
+{
+    allocations++;
+    allocated_bytes += size;
+    if (void *ptr = std::malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+/**
+ * @class AllocationCounter
+ *
+ * @brief Records the heap allocations made during a benchmark and reports
+ * them as counters averaged per iteration.
+ *
+ * Usage:
+ * \code
+ * AllocationCounter counter(state);
+ * for (auto _ : state) { ... }
+ * counter.report();
+ * \endcode
+ */
+class AllocationCounter
+{
+    benchmark::State &state;
+    size_t count0;
+    size_t bytes0;
+
+  public:
+    AllocationCounter(benchmark::State &state)
+        : state(state), count0(allocations), bytes0(allocated_bytes) {}
+
+    /**
+     * @brief Adds the allocations and bytes allocated per iteration to the
+     * benchmark counters
+     */
+    void report()
+    {
+        state.counters["allocs"] = benchmark::Counter(
+            allocations - count0, benchmark::Counter::kAvgIterations);
+        state.counters["bytes_allocated"] = benchmark::Counter(
+            allocated_bytes - bytes0, benchmark::Counter::kAvgIterations,
+            benchmark::Counter::kIs1024);
+    }
+};
+
+#endif // _BENCH_HPP_
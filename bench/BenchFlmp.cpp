@@ -0,0 +1,156 @@
+#include "Bench.hpp"
+
+#include <functions>
+
+// Flmp construction with (1) and without (0) derivatives
+static void BM_Flmp(benchmark::State &state)
+{
+    const int l_max = state.range(0);
+    const bool derivatives = state.range(1);
+    const double I = 89 * M_PI / 180;
+    AllocationCounter counter(state);
+    for (auto _ : state)
+    {
+        Flmp flmp(l_max, I, derivatives);
+        benchmark::DoNotOptimize(flmp.get_Flmp(l_max, l_max, 0));
+    }
+    counter.report();
+    state.SetItemsProcessed(state.iterations() * Flmp::size(l_max));
+}
+BENCHMARK(BM_Flmp)
+    ->ArgsProduct({{30, 60, 120, 240, 360, 720}, {0, 1}})
+    ->ArgNames({"L", "derivatives"})
+    ->Unit(benchmark::kMillisecond);
+
+// Flmp construction versus inclination (in degrees)
+static void BM_FlmpInclination(benchmark::State &state)
+{
+    const int l_max = 120;
+    const double I = state.range(0) * M_PI / 180;
+    AllocationCounter counter(state);
+    for (auto _ : state)
+    {
+        Flmp flmp(l_max, I, true);
+        benchmark::DoNotOptimize(flmp.get_Flmp(l_max, l_max, 0));
+    }
+    counter.report();
+    state.SetItemsProcessed(state.iterations() * Flmp::size(l_max));
+}
+BENCHMARK(BM_FlmpInclination)
+    ->DenseRange(10, 170, 40)
+    ->ArgName("I")
+    ->Unit(benchmark::kMillisecond);
+
+// Flmp construction by FFT (0) and recursion (1) engines, with derivatives:
+// the crossover degree is where the recursion stops being faster
+static void BM_FlmpEngine(benchmark::State &state)
+{
+    const int l_max = state.range(0);
+    const Flmp::Engine engine =
+        state.range(1) ? Flmp::Recursion : Flmp::FFT;
+    const double I = 89 * M_PI / 180;
+    AllocationCounter counter(state);
+    for (auto _ : state)
+    {
+        Flmp flmp(l_max, I, true, Storage(), engine);
+        benchmark::DoNotOptimize(flmp.get_Flmp(l_max, l_max, 0));
+    }
+    counter.report();
+    state.SetItemsProcessed(state.iterations() * Flmp::size(l_max));
+}
+BENCHMARK(BM_FlmpEngine)
+    ->ArgsProduct({{10, 30, 60, 120, 240, 500}, {0, 1}})
+    ->ArgNames({"L", "engine"})
+    ->Unit(benchmark::kMillisecond);
+
+// Flmp construction at 64 inclinations, one by one (0) or batched (1)
+static void BM_FlmpBatch(benchmark::State &state)
+{
+    const int l_max = state.range(0);
+    const bool batched = state.range(1);
+    std::vector<double> I(64);
+    for (size_t j = 0; j < I.size(); j++)
+    {
+        I[j] = (j + 0.5) * M_PI / I.size();
+    }
+    AllocationCounter counter(state);
+    for (auto _ : state)
+    {
+        // Both keep every table, as the caller of a batch does
+        std::vector<Flmp> tables;
+        if (batched)
+        {
+            tables = Flmp::batch(l_max, I, true);
+        }
+        else
+        {
+            for (double I_j : I)
+            {
+                tables.emplace_back(l_max, I_j, true);
+            }
+        }
+        benchmark::DoNotOptimize(tables.back().get_Flmp(l_max, l_max, 0));
+    }
+    counter.report();
+    state.SetItemsProcessed(state.iterations() * I.size() * Flmp::size(l_max));
+}
+BENCHMARK(BM_FlmpBatch)
+    ->ArgsProduct({{10, 30, 60, 120}, {0, 1}})
+    ->ArgNames({"L", "batched"})
+    ->Unit(benchmark::kMillisecond);
+
+// Flmp construction with derivatives versus number of threads
+static void BM_FlmpThreads(benchmark::State &state)
+{
+    const int l_max = state.range(0);
+    const Flmp::Engine engine =
+        state.range(1) ? Flmp::Recursion : Flmp::FFT;
+    ThreadPool pool(state.range(2));
+    const double I = 89 * M_PI / 180;
+    AllocationCounter counter(state);
+    for (auto _ : state)
+    {
+        Flmp flmp(l_max, I, true, Storage(), engine, &pool);
+        benchmark::DoNotOptimize(flmp.get_Flmp(l_max, l_max, 0));
+    }
+    counter.report();
+    state.SetItemsProcessed(state.iterations() * Flmp::size(l_max));
+}
+BENCHMARK(BM_FlmpThreads)
+    ->ArgsProduct({{240, 720}, {0, 1}, {1, 2, 4, 8}})
+    ->ArgNames({"L", "engine", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Flmp with derivatives at a drifting inclination: rebuilt with the FFT (0)
+// or recursion (1) engines, or evaluated from Chebyshev expansions (2)
+static void BM_FlmpChebyshev(benchmark::State &state)
+{
+    const int l_max = state.range(0);
+    const int method = state.range(1);
+    const double I_min = 89 * M_PI / 180, I_max = 90 * M_PI / 180;
+    FlmpChebyshev table;
+    if (method == 2)
+        table = FlmpChebyshev(l_max, I_min, I_max, 1e-10, true);
+    Flmp flmp;
+    int step = 0;
+    AllocationCounter counter(state);
+    for (auto _ : state)
+    {
+        const double I = I_min + (I_max - I_min) * (step++ % 97) / 97;
+        if (method == 2)
+            table.evaluate(I, flmp);
+        else
+            flmp = Flmp(l_max, I, true, Storage(),
+                        method ? Flmp::Recursion : Flmp::FFT);
+        benchmark::DoNotOptimize(flmp.get_Flmp(l_max, l_max, 0));
+    }
+    counter.report();
+    state.SetItemsProcessed(state.iterations() * Flmp::size(l_max));
+}
+BENCHMARK(BM_FlmpChebyshev)
+    ->ArgsProduct({{30, 60, 120}, {0, 1, 2}})
+    ->ArgNames({"L", "method"})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,41 @@
+#include "Bench.hpp"
+
+#include <functions>
+
+// Construction of a private table of normalization constants
+static void BM_Nlm(benchmark::State &state)
+{
+    const int l_max = state.range(0);
+    AllocationCounter counter(state);
+    for (auto _ : state)
+    {
+        Nlm nlm(l_max);
+        benchmark::DoNotOptimize(nlm.get_Nlm(l_max, l_max));
+    }
+    counter.report();
+    state.SetItemsProcessed(state.iterations() * (l_max + 1) * (l_max + 2) / 2);
+}
+BENCHMARK(BM_Nlm)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(2000)
+    ->ArgName("L")
+    ->Unit(benchmark::kMicrosecond);
+
+// Retrieval of the shared table (see Nlm::get)
+static void BM_NlmShared(benchmark::State &state)
+{
+    const int l_max = state.range(0);
+    Nlm::get(l_max);
+    AllocationCounter counter(state);
+    for (auto _ : state)
+    {
+        auto nlm = Nlm::get(l_max);
+        benchmark::DoNotOptimize(nlm->get_Nlm(l_max, l_max));
+    }
+    counter.report();
+}
+BENCHMARK(BM_NlmShared)->Arg(2000)->ArgName("L");
+
+BENCHMARK_MAIN();
@@ -0,0 +1,50 @@
+#include "Bench.hpp"
+
+#include <functions>
+
+// Degrees from typical orbit propagation to high resolution gravity fields
+static const std::vector<int64_t> degrees = {10, 20, 50, 100, 200, 500, 1000, 2000};
+
+// Plm construction: 0 values, 1 first derivatives, 2 second derivatives
+static void BM_Plm(benchmark::State &state)
+{
+    const int l_max = state.range(0);
+    const int derivatives = state.range(1);
+    const double theta = 65 * M_PI / 180;
+    AllocationCounter counter(state);
+    for (auto _ : state)
+    {
+        Plm plm(l_max, theta, derivatives >= 1, derivatives >= 2);
+        benchmark::DoNotOptimize(plm.get_Plm_bar(l_max, l_max));
+    }
+    counter.report();
+    state.SetItemsProcessed(state.iterations() * (l_max + 1) * (l_max + 2) / 2);
+}
+BENCHMARK(BM_Plm)
+    ->ArgsProduct({degrees, {0, 1, 2}})
+    ->ArgNames({"L", "derivatives"})
+    ->Unit(benchmark::kMicrosecond);
+
+// In-place re-evaluation of an existing Plm (allocation-free)
+static void BM_PlmEvaluate(benchmark::State &state)
+{
+    const int l_max = state.range(0);
+    const int derivatives = state.range(1);
+    Plm plm(l_max, 0.1, derivatives >= 1, derivatives >= 2);
+    double theta = 0.1;
+    AllocationCounter counter(state);
+    for (auto _ : state)
+    {
+        theta = theta < 3 ? theta + 1e-3 : 0.1;
+        plm.evaluate(theta);
+        benchmark::DoNotOptimize(plm.get_Plm_bar(l_max, l_max));
+    }
+    counter.report();
+    state.SetItemsProcessed(state.iterations() * (l_max + 1) * (l_max + 2) / 2);
+}
+BENCHMARK(BM_PlmEvaluate)
+    ->ArgsProduct({degrees, {0, 1, 2}})
+    ->ArgNames({"L", "derivatives"})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,197 @@
+/**
+ * @file Buffer.hpp
+ *
+ * @brief Header file to define the storage of large tables
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _BUFFER_HPP_
+#define _BUFFER_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @struct Storage
+ *
+ * @brief Describes how the memory of a Buffer is obtained.
+ *
+ * - Heap: regular heap allocation.
+ * - HugePages: anonymous memory mapping advised to be backed by transparent
+ * huge pages, which reduces TLB pressure for multi-gigabyte tables.
+ * - File: shared mapping of an unnamed temporary file created in dir, so that
+ * the table can be paged to disk by the operating system. The file is removed
+ * as soon as it is mapped.
+ */
+struct Storage {
+    enum Kind { Heap, HugePages, File };
+    Kind kind = Heap;        // Kind of memory
+    std::string dir = "/tmp"; // Directory of the backing file (File only)
+};
+
+/**
+ * @class BasicBuffer
+ *
+ * @brief Fixed-size array of scalars with selectable storage.
+ *
+ * Sizes are 64-bit, so a Buffer can hold tables far beyond the range of int
+ * (e.g. inclination functions up to degree 2190 and beyond). Copies allocate
+ * memory of the same kind.
+ *
+ * @tparam T Scalar type of the stored values
+ */
+template <typename T> class BasicBuffer {
+    T *_data = nullptr;      // Stored values
+    size_t _size = 0;        // Number of stored values
+    size_t _bytes = 0;       // Length of the memory mapping (0 for heap)
+    Storage storage;         // Storage of the values
+
+    /**
+     * Function that allocates the memory for the current size and storage.
+     */
+    void allocate() {
+        if (_size == 0)
+            return;
+        if (storage.kind == Storage::Heap) {
+            _data = new T[_size];
+            return;
+        }
+        _bytes = _size * sizeof(T);
+        void *ptr = MAP_FAILED;
+        if (storage.kind == Storage::HugePages) {
+            ptr = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (ptr == MAP_FAILED)
+                throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+            madvise(ptr, _bytes, MADV_HUGEPAGE);
+#endif
+        } else {
+            std::string path = storage.dir + "/functions-XXXXXX";
+            int fd = mkstemp(&path[0]);
+            if (fd < 0)
+                throw std::runtime_error("Buffer: cannot create file in " +
+                                         storage.dir);
+            unlink(path.c_str());
+            if (ftruncate(fd, _bytes) == 0) {
+                ptr = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                           fd, 0);
+            }
+            close(fd);
+            if (ptr == MAP_FAILED)
+                throw std::runtime_error("Buffer: cannot map file in " +
+                                         storage.dir);
+        }
+        _data = static_cast<T *>(ptr);
+    };
+
+    /**
+     * Function that releases the memory.
+     */
+    void release() {
+        if (_data) {
+            if (_bytes)
+                munmap(_data, _bytes);
+            else
+                delete[] _data;
+        }
+        _data = nullptr;
+        _size = 0;
+        _bytes = 0;
+    };
+
+  public:
+    /**
+     * Default constructor
+     */
+    BasicBuffer() {};
+
+    /**
+     * Class constructor. Values are left uninitialised.
+     * @param size Number of values
+     * @param storage Storage of the values
+     */
+    BasicBuffer(size_t size, const Storage &storage = Storage())
+        : _size(size), storage(storage) {
+        allocate();
+    };
+
+    // Copy constructor
+    BasicBuffer(const BasicBuffer &other)
+        : _size(other._size), storage(other.storage) {
+        allocate();
+        std::copy(other._data, other._data + _size, _data);
+    };
+
+    // Move constructor
+    BasicBuffer(BasicBuffer &&other) noexcept
+        : _data(other._data), _size(other._size), _bytes(other._bytes),
+          storage(std::move(other.storage)) {
+        other._data = nullptr;
+        other._size = 0;
+        other._bytes = 0;
+    };
+
+    // Copy assignment operator
+    BasicBuffer &operator=(const BasicBuffer &other) {
+        if (this != &other) {
+            release();
+            _size = other._size;
+            storage = other.storage;
+            allocate();
+            std::copy(other._data, other._data + _size, _data);
+        }
+        return *this;
+    };
+
+    // Move assignment operator
+    BasicBuffer &operator=(BasicBuffer &&other) noexcept {
+        if (this != &other) {
+            release();
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+            std::swap(_bytes, other._bytes);
+            storage = std::move(other.storage);
+        }
+        return *this;
+    };
+
+    // Destructor
+    ~BasicBuffer() { release(); };
+
+    /**
+     * @brief Getter for stored values
+     */
+    T *data() { return _data; };
+
+    /**
+     * @brief Getter for stored values
+     */
+    const T *data() const { return _data; };
+
+    /**
+     * @brief Getter for number of values
+     */
+    size_t size() const { return _size; };
+
+    /**
+     * @brief Getter for storage of the values
+     */
+    const Storage &get_storage() const { return storage; };
+
+    T &operator[](size_t i) { return _data[i]; };
+
+    T operator[](size_t i) const { return _data[i]; };
+};
+
+typedef BasicBuffer<double> Buffer;
+
+#endif // _BUFFER_HPP_
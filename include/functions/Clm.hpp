@@ -0,0 +1,95 @@
+/**
+ * @file Clm.hpp
+ *
+ * @brief Header file to define sets of spherical harmonic coefficients
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _CLM_HPP_
+#define _CLM_HPP_
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class Clm
+ *
+ * @brief Class that stores a set of fully-normalized spherical harmonic
+ * coefficients.
+ *
+ * The coefficients \f$ \bar{C}_{lm}, \bar{S}_{lm} \f$ define a function on the
+ * sphere (e.g. a gravity potential) as:
+ * \f[
+ * f(\theta, \lambda) = \sum_{l=0}^{L} \sum_{m=0}^{l} \bar{P}_{lm}(\theta)
+ * (\bar{C}_{lm} \cos{m\lambda} + \bar{S}_{lm} \sin{m\lambda})
+ * \f]
+ * with the normalization described in Nlm.hpp. All coefficients are
+ * initialised to zero.
+ */
+class Clm {
+    int l_max;             // Maximum degree
+    std::vector<double> C; // Cosine coefficients
+    std::vector<double> S; // Sine coefficients
+
+    /**
+     * Function that computes global index for internal data structure.
+     * @param l degree
+     * @param m order
+     * @return Global index
+     */
+    size_t lm_idx(int l, int m) const {
+        return (static_cast<size_t>(l) * (l + 1)) / 2 + m;
+    };
+
+  public:
+    /**
+     * Default constructor
+     */
+    Clm() : l_max(-1) {};
+
+    /**
+     * Class constructor
+     * @param l_max Maximum degree of the coefficients
+     */
+    Clm(int l_max)
+        : l_max(l_max), C(lm_idx(l_max + 1, 0), 0.0),
+          S(lm_idx(l_max + 1, 0), 0.0) {};
+
+    /**
+     * @brief Getter for maximum degree
+     */
+    int get_l_max() const { return l_max; };
+
+    /**
+     * @brief Getter for cosine coefficient
+     * @param l degree
+     * @param m order
+     */
+    double get_C(int l, int m) const { return C[lm_idx(l, m)]; };
+
+    /**
+     * @brief Getter for sine coefficient
+     * @param l degree
+     * @param m order
+     */
+    double get_S(int l, int m) const { return S[lm_idx(l, m)]; };
+
+    /**
+     * @brief Setter for cosine coefficient
+     * @param l degree
+     * @param m order
+     * @param value coefficient
+     */
+    void set_C(int l, int m, double value) { C[lm_idx(l, m)] = value; };
+
+    /**
+     * @brief Setter for sine coefficient
+     * @param l degree
+     * @param m order
+     * @param value coefficient
+     */
+    void set_S(int l, int m, double value) { S[lm_idx(l, m)] = value; };
+};
+
+#endif // _CLM_HPP_
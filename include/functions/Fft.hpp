@@ -0,0 +1,831 @@
+/**
+ * @file Fft.hpp
+ *
+ * @brief Header file to define planned Fast Fourier Transforms (FFTs)
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _FFT_HPP_
+#define _FFT_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include "Scalar.hpp"
+
+/**
+ * @class BasicFft
+ *
+ * @brief Class that stores the plan of a complex FFT of a given length.
+ *
+ * The forward transform is defined as:
+ * \f[
+ * X_k = \sum_{j=0}^{N-1} x_j e^{-2\pi i jk/N}
+ * \f]
+ * and the inverse transform uses the opposite sign in the exponent without
+ * any normalization, so that applying both yields \f$ N x_j \f$.
+ *
+ * Lengths with no prime factors other than 2, 3, 5 and 7 are transformed with
+ * Stockham's autosort algorithm: radix-4 stages, then radix-3, 5 and 7 stages
+ * and a final radix-2 stage for odd powers of two, that read one buffer and
+ * write another, so that no bit-reversal permutation is needed.
+ * The data is kept in split format (separate arrays of real and imaginary
+ * parts) and the twiddle factors of every stage are stored contiguously, so
+ * the butterflies of a stage are independent, unit-stride loops that the
+ * compiler vectorizes (across sub-transforms, or across butterflies in the
+ * first stage). Callers holding split data can use the split overloads to
+ * skip the conversion from and to arrays of std::complex.
+ *
+ * Batches of transforms of the same length can be applied at once on data
+ * interleaved across transforms, i.e. sample j of transform b stored at
+ * \f$ j \cdot batch + b \f$. The twiddle factors of a butterfly are shared
+ * by the whole batch, so every stage becomes a single unit-stride loop over
+ * the sub-transforms of all the transforms of the batch, which keeps the
+ * vector units busy even for short transforms.
+ *
+ * Any other length is reduced to a power of two convolution with Bluestein's
+ * chirp-z algorithm. The twiddle factors and chirps are computed once when
+ * building the plan, so the transforms never evaluate any trigonometric
+ * function nor allocate memory.
+ *
+ * A plan holds an internal workspace, so a single plan must not be shared
+ * among threads executing transforms concurrently.
+ *
+ * @tparam T Scalar type of the real and imaginary parts (see Scalar.hpp)
+ */
+template <typename T> class BasicFft {
+    typedef std::complex<T> complex;
+
+    int n;                  // Length of the transform
+    std::vector<int> radix; // Radices of the Stockham stages
+    std::vector<T> twiddle; // Twiddle factors of the stages (split)
+    mutable std::vector<T> work;   // Stockham workspace (split)
+    mutable std::vector<T> buffer; // Split copy of complex data
+
+    std::unique_ptr<BasicFft> conv;     // Power of two plan for Bluestein
+    std::vector<complex> chirp;         // Bluestein chirp
+    std::vector<complex> kernel;        // Transformed Bluestein kernel
+    mutable std::vector<complex> cwork; // Bluestein workspace
+
+    /**
+     * Function that applies a radix-4 butterfly.
+     * @param xr, xi Input of the butterfly, with elements at 0, m, 2m, 3m
+     * @param yr, yi Output of the butterfly, with elements at 0, s, 2s, 3s
+     * @param m Input stride
+     * @param s Output stride
+     * @param w Twiddle factors of the butterfly, with the real and imaginary
+     * parts of \f$ W^p, W^{2p}, W^{3p} \f$ at 0, M, ..., 5M
+     * @param M Number of butterflies of the stage
+     */
+    static void butterfly4(const T *xr, const T *xi, T *yr, T *yi, int m,
+                           int s, const T *w, int M) {
+        const T ar = xr[0], ai = xi[0];
+        const T br = xr[m], bi = xi[m];
+        const T cr = xr[2 * m], ci = xi[2 * m];
+        const T dr = xr[3 * m], di = xi[3 * m];
+        // Sums and differences of opposite inputs, with -i(b-d)
+        const T apcr = ar + cr, apci = ai + ci;
+        const T amcr = ar - cr, amci = ai - ci;
+        const T bpdr = br + dr, bpdi = bi + di;
+        const T jbdr = bi - di, jbdi = dr - br;
+        const T w1r = w[0], w1i = w[M];
+        const T w2r = w[2 * M], w2i = w[3 * M];
+        const T w3r = w[4 * M], w3i = w[5 * M];
+        yr[0] = apcr + bpdr;
+        yi[0] = apci + bpdi;
+        const T u1r = amcr + jbdr, u1i = amci + jbdi;
+        yr[s] = w1r * u1r - w1i * u1i;
+        yi[s] = w1r * u1i + w1i * u1r;
+        const T u2r = apcr - bpdr, u2i = apci - bpdi;
+        yr[2 * s] = w2r * u2r - w2i * u2i;
+        yi[2 * s] = w2r * u2i + w2i * u2r;
+        const T u3r = amcr - jbdr, u3i = amci - jbdi;
+        yr[3 * s] = w3r * u3r - w3i * u3i;
+        yi[3 * s] = w3r * u3i + w3i * u3r;
+    };
+
+    /**
+     * Function that applies a radix-4 Stockham stage, which splits each of
+     * the s sub-transforms of length n_s into four of length n_s/4.
+     * @param n_s Length of the sub-transforms
+     * @param s Number of sub-transforms (stride)
+     * @param xr, xi Input of the stage
+     * @param yr, yi Output of the stage
+     * @param w Twiddle factors table of the stage
+     *
+     * The input and output of a stage never overlap, which is asserted to
+     * the compiler (ivdep) so that it vectorizes the loops without run-time
+     * alias checks.
+     */
+    static void radix4(int n_s, int s, const T *xr, const T *xi, T *yr,
+                       T *yi, const T *w) {
+        const int m = n_s / 4;
+        if (s == 1) {
+            // Vectorized across butterflies
+#pragma GCC ivdep
+            for (int p = 0; p < m; p++) {
+                butterfly4(xr + p, xi + p, yr + 4 * p, yi + 4 * p, m, 1,
+                           w + p, m);
+            }
+            return;
+        }
+        // Vectorized across sub-transforms
+        for (int p = 0; p < m; p++) {
+            const T *x_r = xr + s * p, *x_i = xi + s * p;
+            T *y_r = yr + 4 * s * p, *y_i = yi + 4 * s * p;
+#pragma GCC ivdep
+            for (int q = 0; q < s; q++) {
+                butterfly4(x_r + q, x_i + q, y_r + q, y_i + q, m * s, s,
+                           w + p, m);
+            }
+        }
+    };
+
+    /**
+     * Function that applies a radix-R butterfly for an odd R, pairing the
+     * outputs k and R-k so that they share the products by the cosines and
+     * sines of the roots of unity.
+     * @param xr, xi Input of the butterfly, with elements at 0, m, ...
+     * @param yr, yi Output of the butterfly, with elements at 0, s, ...
+     * @param m Input stride
+     * @param s Output stride
+     * @param w Twiddle factors of the butterfly, with the real and imaginary
+     * parts of \f$ W^{kp}, 1 \leq k < R \f$ at 0, M, ..., (2R-3)M
+     * @param M Number of butterflies of the stage
+     * @param root Cosines and sines of \f$ 2\pi t/R \f$ at t and R+t
+     */
+    template <int R>
+    static void butterfly(const T *xr, const T *xi, T *yr, T *yi, int m, int s,
+                          const T *w, int M, const T *root) {
+        constexpr int H = (R - 1) / 2;
+        T sr[H + 1], si[H + 1], dr[H + 1], di[H + 1];
+        const T ar = xr[0], ai = xi[0];
+        T b0r = ar, b0i = ai;
+        for (int j = 1; j <= H; j++) {
+            // Sums and differences of opposite inputs
+            sr[j] = xr[j * m] + xr[(R - j) * m];
+            si[j] = xi[j * m] + xi[(R - j) * m];
+            dr[j] = xr[j * m] - xr[(R - j) * m];
+            di[j] = xi[j * m] - xi[(R - j) * m];
+            b0r += sr[j];
+            b0i += si[j];
+        }
+        yr[0] = b0r;
+        yi[0] = b0i;
+        for (int k = 1; k <= H; k++) {
+            T Ar = ar, Ai = ai, Br = 0, Bi = 0;
+            for (int j = 1; j <= H; j++) {
+                const int t = (j * k) % R;
+                Ar += sr[j] * root[t];
+                Ai += si[j] * root[t];
+                Br += dr[j] * root[R + t];
+                Bi += di[j] * root[R + t];
+            }
+            // Outputs k and R-k, before the twiddle factors
+            const T ukr = Ar + Bi, uki = Ai - Br;
+            const T vkr = Ar - Bi, vki = Ai + Br;
+            const T wkr = w[2 * (k - 1) * M], wki = w[(2 * k - 1) * M];
+            const T wlr = w[2 * (R - k - 1) * M];
+            const T wli = w[(2 * (R - k) - 1) * M];
+            yr[k * s] = wkr * ukr - wki * uki;
+            yi[k * s] = wkr * uki + wki * ukr;
+            yr[(R - k) * s] = wlr * vkr - wli * vki;
+            yi[(R - k) * s] = wlr * vki + wli * vkr;
+        }
+    };
+
+    /**
+     * Function that applies a radix-R Stockham stage for an odd R, which
+     * splits each of the s sub-transforms of length n_s into R of length
+     * n_s/R (see radix4).
+     * @param n_s Length of the sub-transforms
+     * @param s Number of sub-transforms (stride)
+     * @param xr, xi Input of the stage
+     * @param yr, yi Output of the stage
+     * @param w Twiddle factors table of the stage, followed by the cosines
+     * and sines of the roots of unity of order R
+     */
+    template <int R>
+    static void radix_odd(int n_s, int s, const T *xr, const T *xi, T *yr,
+                          T *yi, const T *w) {
+        const int m = n_s / R;
+        const T *root = w + 2 * (R - 1) * m;
+        if (s == 1) {
+            // Vectorized across blocks of butterflies, whose outputs are
+            // then interleaved
+            constexpr int V = 8;
+            T tr[R * V], ti[R * V];
+            int p0 = 0;
+            for (; p0 + V <= m; p0 += V) {
+#pragma GCC ivdep
+                for (int p = 0; p < V; p++) {
+                    butterfly<R>(xr + p0 + p, xi + p0 + p, tr + p, ti + p, m,
+                                 V, w + p0 + p, m, root);
+                }
+                for (int p = 0; p < V; p++) {
+                    for (int k = 0; k < R; k++) {
+                        yr[R * (p0 + p) + k] = tr[k * V + p];
+                        yi[R * (p0 + p) + k] = ti[k * V + p];
+                    }
+                }
+            }
+            for (int p = p0; p < m; p++) {
+                butterfly<R>(xr + p, xi + p, yr + R * p, yi + R * p, m, 1,
+                             w + p, m, root);
+            }
+            return;
+        }
+        // Vectorized across sub-transforms
+        for (int p = 0; p < m; p++) {
+            const T *x_r = xr + s * p, *x_i = xi + s * p;
+            T *y_r = yr + R * s * p, *y_i = yi + R * s * p;
+#pragma GCC ivdep
+            for (int q = 0; q < s; q++) {
+                butterfly<R>(x_r + q, x_i + q, y_r + q, y_i + q, m * s, s,
+                             w + p, m, root);
+            }
+        }
+    };
+
+    /**
+     * Function that applies the final radix-2 Stockham stage.
+     * @param s Number of sub-transforms of length 2
+     * @param xr, xi Input of the stage
+     * @param yr, yi Output of the stage
+     */
+    static void radix2(int s, const T *xr, const T *xi, T *yr, T *yi) {
+#pragma GCC ivdep
+        for (int q = 0; q < s; q++) {
+            const T ar = xr[q], ai = xi[q];
+            const T br = xr[q + s], bi = xi[q + s];
+            yr[q] = ar + br;
+            yi[q] = ai + bi;
+            yr[q + s] = ar - br;
+            yi[q + s] = ai - bi;
+        }
+    };
+
+    /**
+     * Function that applies Stockham's algorithm to a batch of split data.
+     * @param batch Number of transforms, interleaved
+     * @param xr, xi Data to be transformed
+     * @param yr, yi Transformed data (it may alias the input)
+     */
+    void stockham(int batch, const T *xr, const T *xi, T *yr, T *yi) const {
+        const size_t size = static_cast<size_t>(n) * batch;
+        if (work.size() < 4 * size)
+            work.resize(4 * size);
+        T *ar = work.data(), *ai = ar + size;
+        T *br = ai + size, *bi = br + size;
+        const int n_stages = radix.size();
+        if (n_stages == 0) {
+            std::copy(xr, xr + size, yr);
+            std::copy(xi, xi + size, yi);
+            return;
+        }
+        if (n_stages == 1) {
+            // A single stage cannot run in place
+            std::copy(xr, xr + size, ar);
+            std::copy(xi, xi + size, ai);
+            xr = ar;
+            xi = ai;
+        }
+        const T *w = twiddle.data();
+        int n_s = n, s = 1;
+        for (int stage = 1; stage <= n_stages; stage++) {
+            // Ping-pong between workspaces, the last stage writes the output
+            T *zr = stage == n_stages ? yr : (xr == ar ? br : ar);
+            T *zi = stage == n_stages ? yi : (xr == ar ? bi : ai);
+            // Sub-transforms of all the transforms of the batch
+            const int R = radix[stage - 1];
+            switch (R) {
+            case 2:
+                radix2(s * batch, xr, xi, zr, zi);
+                break;
+            case 3:
+                radix_odd<3>(n_s, s * batch, xr, xi, zr, zi, w);
+                break;
+            case 4:
+                radix4(n_s, s * batch, xr, xi, zr, zi, w);
+                break;
+            case 5:
+                radix_odd<5>(n_s, s * batch, xr, xi, zr, zi, w);
+                break;
+            case 7:
+                radix_odd<7>(n_s, s * batch, xr, xi, zr, zi, w);
+                break;
+            }
+            w += 2 * (R - 1) * (n_s / R) + (R % 2 != 0 ? 2 * R : 0);
+            n_s /= R;
+            s *= R;
+            xr = zr;
+            xi = zi;
+        }
+    };
+
+    /**
+     * Function that applies Bluestein's algorithm.
+     * @param in Data to be transformed
+     * @param out Transformed data (it may alias the input)
+     */
+    void bluestein(const complex *in, complex *out) const {
+        const int M = conv->get_n();
+        for (int j = 0; j < n; j++) {
+            cwork[j] = in[j] * chirp[j];
+        }
+        std::fill(cwork.begin() + n, cwork.begin() + M, complex(0));
+        conv->forward(cwork.data(), cwork.data());
+        for (int j = 0; j < M; j++) {
+            cwork[j] *= kernel[j];
+        }
+        conv->inverse(cwork.data(), cwork.data());
+        const T scale = T(1) / M;
+        for (int k = 0; k < n; k++) {
+            out[k] = cwork[k] * chirp[k] * scale;
+        }
+    };
+
+  public:
+    /**
+     * Class constructor
+     * @param n Length of the transform
+     */
+    BasicFft(int n) : n(n) {
+        if (is_fast(n)) {
+            // Stockham plan: radix-4, radix-3, 5 and 7 stages and a final
+            // radix-2 stage
+            int r = n;
+            for (int R : {4, 3, 5, 7}) {
+                for (; r % R == 0; r /= R)
+                    radix.push_back(R);
+            }
+            if (r == 2)
+                radix.push_back(2);
+            int n_s = n;
+            for (int R : radix) {
+                if (R == 2)
+                    break;
+                const int m = n_s / R;
+                for (int k = 1; k < R; k++) {
+                    std::vector<T> re(m), im(m);
+                    for (int p = 0; p < m; p++) {
+                        const complex w = Scalar<T>::polar(
+                            -2 * Scalar<T>::pi() * k * p / n_s);
+                        re[p] = w.real();
+                        im[p] = w.imag();
+                    }
+                    twiddle.insert(twiddle.end(), re.begin(), re.end());
+                    twiddle.insert(twiddle.end(), im.begin(), im.end());
+                }
+                if (R % 2 != 0) {
+                    // Roots of unity of the butterflies
+                    for (int t = 0; t < R; t++) {
+                        twiddle.push_back(
+                            Scalar<T>::cos(2 * Scalar<T>::pi() * t / R));
+                    }
+                    for (int t = 0; t < R; t++) {
+                        twiddle.push_back(
+                            Scalar<T>::sin(2 * Scalar<T>::pi() * t / R));
+                    }
+                }
+                n_s = m;
+            }
+            work.resize(4 * n);
+            buffer.resize(2 * n);
+            return;
+        }
+        // Bluestein plan
+        int M = 1;
+        while (M < 2 * n - 1)
+            M <<= 1;
+        conv = std::make_unique<BasicFft>(M);
+        chirp.resize(n);
+        for (int j = 0; j < n; j++) {
+            // Reduce j^2 modulo 2n to keep the argument accurate
+            const long long j2 = (static_cast<long long>(j) * j) % (2 * n);
+            chirp[j] = Scalar<T>::polar(-Scalar<T>::pi() * j2 / n);
+        }
+        kernel.assign(M, complex(0));
+        kernel[0] = 1;
+        for (int j = 1; j < n; j++) {
+            kernel[j] = kernel[M - j] = std::conj(chirp[j]);
+        }
+        conv->forward(kernel.data(), kernel.data());
+        cwork.resize(M + n);
+    };
+
+    // Copy constructor
+    BasicFft(const BasicFft &other) : BasicFft(other.n) {};
+
+    // Move constructor
+    BasicFft(BasicFft &&other) = default;
+
+    // Copy assignment operator
+    BasicFft &operator=(const BasicFft &other) {
+        if (this != &other)
+            *this = BasicFft(other.n);
+        return *this;
+    };
+
+    // Move assignment operator
+    BasicFft &operator=(BasicFft &&other) = default;
+
+    /**
+     * @brief Forward transform
+     * @param in Data to be transformed
+     * @param out Transformed data (it may alias the input)
+     */
+    void forward(const complex *in, complex *out) const {
+        if (conv) {
+            bluestein(in, out);
+            return;
+        }
+        T *re = buffer.data(), *im = re + n;
+        for (int j = 0; j < n; j++) {
+            re[j] = in[j].real();
+            im[j] = in[j].imag();
+        }
+        stockham(1, re, im, re, im);
+        for (int k = 0; k < n; k++) {
+            out[k] = complex(re[k], im[k]);
+        }
+    };
+
+    /**
+     * @brief Forward transform of split data
+     * @param in_re, in_im Real and imaginary parts of the data to be
+     * transformed
+     * @param out_re, out_im Real and imaginary parts of the transformed data
+     * (they may alias the input)
+     */
+    void forward(const T *in_re, const T *in_im, T *out_re, T *out_im) const {
+        forward_batch(1, in_re, in_im, out_re, out_im);
+    };
+
+    /**
+     * @brief Forward transform of a batch of split data, interleaved across
+     * transforms (sample j of transform b at j * batch + b)
+     * @param batch Number of transforms
+     * @param in_re, in_im Real and imaginary parts of the data to be
+     * transformed
+     * @param out_re, out_im Real and imaginary parts of the transformed data
+     * (they may alias the input)
+     */
+    void forward_batch(int batch, const T *in_re, const T *in_im, T *out_re,
+                       T *out_im) const {
+        if (!conv) {
+            stockham(batch, in_re, in_im, out_re, out_im);
+            return;
+        }
+        // Bluestein's algorithm, one transform at a time
+        complex *data = cwork.data() + conv->get_n();
+        for (int b = 0; b < batch; b++) {
+            for (int j = 0; j < n; j++) {
+                data[j] = complex(in_re[j * batch + b], in_im[j * batch + b]);
+            }
+            bluestein(data, data);
+            for (int k = 0; k < n; k++) {
+                out_re[k * batch + b] = data[k].real();
+                out_im[k * batch + b] = data[k].imag();
+            }
+        }
+    };
+
+    /**
+     * @brief Inverse transform (without normalization)
+     * @param in Data to be transformed
+     * @param out Transformed data (it may alias the input)
+     */
+    void inverse(const complex *in, complex *out) const {
+        for (int j = 0; j < n; j++) {
+            out[j] = std::conj(in[j]);
+        }
+        forward(out, out);
+        for (int j = 0; j < n; j++) {
+            out[j] = std::conj(out[j]);
+        }
+    };
+
+    /**
+     * @brief Inverse transform (without normalization) of split data
+     * @param in_re, in_im Real and imaginary parts of the data to be
+     * transformed
+     * @param out_re, out_im Real and imaginary parts of the transformed data
+     * (they may alias the input)
+     */
+    void inverse(const T *in_re, const T *in_im, T *out_re, T *out_im) const {
+        // Swapping real and imaginary parts conjugates the exponent
+        forward(in_im, in_re, out_im, out_re);
+    };
+
+    /**
+     * @brief Inverse transform (without normalization) of a batch of split
+     * data, interleaved across transforms (see forward_batch)
+     * @param batch Number of transforms
+     * @param in_re, in_im Real and imaginary parts of the data to be
+     * transformed
+     * @param out_re, out_im Real and imaginary parts of the transformed data
+     * (they may alias the input)
+     */
+    void inverse_batch(int batch, const T *in_re, const T *in_im, T *out_re,
+                       T *out_im) const {
+        forward_batch(batch, in_im, in_re, out_im, out_re);
+    };
+
+    /**
+     * @brief Getter for length of the transform
+     */
+    int get_n() const { return n; };
+
+    /**
+     * @brief Whether a length is transformed without Bluestein's algorithm,
+     * i.e. it has no prime factors other than 2, 3, 5 and 7
+     * @param n Length of the transform
+     */
+    static bool is_fast(int n) {
+        if (n < 1)
+            return false;
+        for (int R : {2, 3, 5, 7}) {
+            while (n % R == 0)
+                n /= R;
+        }
+        return n == 1;
+    };
+
+    /**
+     * @brief Smallest length not less than a given one that is transformed
+     * without Bluestein's algorithm (see is_fast)
+     * @param n Minimum length of the transform
+     */
+    static int fast_size(int n) {
+        n = std::max(n, 1);
+        while (!is_fast(n))
+            n++;
+        return n;
+    };
+};
+
+typedef BasicFft<double> Fft;
+
+/**
+ * @class BasicRealFft
+ *
+ * @brief Class that stores the plan of a FFT of real data of a given length.
+ *
+ * The spectrum of real data is Hermitian, so only the coefficients
+ * \f$ X_k, 0 \leq k \leq N/2 \f$ are computed (forward) or required (inverse).
+ * For even lengths the real data is packed into a complex sequence of half
+ * the length, which is transformed with a complex plan and then split into the
+ * spectrum of the even and odd samples. Odd lengths fall back to a complex
+ * transform of the whole sequence.
+ *
+ * @tparam T Scalar type of the data (see Scalar.hpp)
+ */
+template <typename T> class BasicRealFft {
+    typedef std::complex<T> complex;
+
+    int n;                             // Length of the transform
+    BasicFft<T> fft;                   // Complex plan
+    std::vector<T> wr, wi;             // Split twiddle factors
+    mutable std::vector<T> zr, zi;     // Workspace (even lengths)
+    mutable std::vector<complex> work; // Workspace (odd lengths)
+
+    /**
+     * Function that applies the forward transform.
+     * @param x Real data of length \f$ N \f$
+     * @param store Function storing the real and imaginary parts of
+     * \f$ X_k \f$, called as store(k, re, im) for \f$ 0 \leq k \leq N/2 \f$
+     */
+    template <typename Store>
+    void apply_forward(const T *x, Store store) const {
+        if (n % 2 != 0) {
+            for (int j = 0; j < n; j++) {
+                work[j] = x[j];
+            }
+            fft.forward(work.data(), work.data());
+            for (int k = 0; k <= n / 2; k++) {
+                store(k, work[k].real(), work[k].imag());
+            }
+            return;
+        }
+        const int h = n / 2;
+        for (int j = 0; j < h; j++) {
+            zr[j] = x[2 * j];
+            zi[j] = x[2 * j + 1];
+        }
+        fft.forward(zr.data(), zi.data(), zr.data(), zi.data());
+        store(0, zr[0] + zi[0], T(0));
+        for (int k = 1; k < h; k++) {
+            // Spectra of the even (E) and odd (O) samples
+            const T Er = T(0.5) * (zr[k] + zr[h - k]);
+            const T Ei = T(0.5) * (zi[k] - zi[h - k]);
+            const T Or = T(0.5) * (zi[k] + zi[h - k]);
+            const T Oi = T(0.5) * (zr[h - k] - zr[k]);
+            store(k, Er + wr[k] * Or - wi[k] * Oi,
+                  Ei + wr[k] * Oi + wi[k] * Or);
+        }
+        store(h, zr[0] - zi[0], T(0));
+    };
+
+    /**
+     * Function that applies the inverse transform.
+     * @param load Function loading the real and imaginary parts of
+     * \f$ X_k \f$, called as load(k, re, im) for \f$ 0 \leq k \leq N/2 \f$
+     * @param x Real data of length \f$ N \f$
+     */
+    template <typename Load> void apply_inverse(Load load, T *x) const {
+        T re, im;
+        if (n % 2 != 0) {
+            load(0, re, im);
+            work[0] = complex(re, im);
+            for (int k = 1; k <= n / 2; k++) {
+                load(k, re, im);
+                work[k] = complex(re, im);
+                work[n - k] = complex(re, -im);
+            }
+            fft.inverse(work.data(), work.data());
+            for (int j = 0; j < n; j++) {
+                x[j] = work[j].real();
+            }
+            return;
+        }
+        const int h = n / 2;
+        T re_c, im_c;
+        for (int k = 0; k < h; k++) {
+            load(k, re, im);
+            load(h - k, re_c, im_c);
+            // Pack the spectra of the even and odd samples
+            const T Ar = re + re_c, Ai = im - im_c;
+            const T Br = re - re_c, Bi = im + im_c;
+            zr[k] = Ar - (wr[k] * Bi - wi[k] * Br);
+            zi[k] = Ai + wr[k] * Br + wi[k] * Bi;
+        }
+        fft.inverse(zr.data(), zi.data(), zr.data(), zi.data());
+        for (int j = 0; j < h; j++) {
+            x[2 * j] = zr[j];
+            x[2 * j + 1] = zi[j];
+        }
+    };
+
+  public:
+    /**
+     * Class constructor
+     * @param n Length of the transform
+     */
+    BasicRealFft(int n) : n(n), fft(n % 2 == 0 ? n / 2 : n) {
+        if (n % 2 != 0) {
+            work.resize(n);
+            return;
+        }
+        wr.resize(n / 2 + 1);
+        wi.resize(n / 2 + 1);
+        for (int k = 0; k <= n / 2; k++) {
+            const complex w = Scalar<T>::polar(-2 * Scalar<T>::pi() * k / n);
+            wr[k] = w.real();
+            wi[k] = w.imag();
+        }
+        zr.resize(n / 2);
+        zi.resize(n / 2);
+    };
+
+    /**
+     * @brief Forward transform
+     * @param x Real data of length \f$ N \f$
+     * @param X Spectrum \f$ X_k, 0 \leq k \leq N/2 \f$
+     */
+    void forward(const T *x, complex *X) const {
+        apply_forward(x, [X](int k, T re, T im) { X[k] = complex(re, im); });
+    };
+
+    /**
+     * @brief Forward transform with split output
+     * @param x Real data of length \f$ N \f$
+     * @param X_re, X_im Real and imaginary parts of the spectrum
+     * \f$ X_k, 0 \leq k \leq N/2 \f$
+     */
+    void forward(const T *x, T *X_re, T *X_im) const {
+        apply_forward(x, [X_re, X_im](int k, T re, T im) {
+            X_re[k] = re;
+            X_im[k] = im;
+        });
+    };
+
+    /**
+     * @brief Preferred number of transforms per batch (see forward_batch)
+     *
+     * Batches pay off while the interleaved data of a batch stays in the L1
+     * cache (about 1024 samples); longer transforms are already vectorized on
+     * their own and are best applied one at a time.
+     */
+    int get_batch() const {
+        if (n % 2 != 0 || n > 128)
+            return 1;
+        return std::min(16, 1024 / n);
+    };
+
+    /**
+     * @brief Forward transform of a batch of real data, interleaved across
+     * transforms (sample j of transform b at j * batch + b)
+     * @param batch Number of transforms
+     * @param x Real data of length \f$ N \f$ per transform
+     * @param X_re, X_im Real and imaginary parts of the spectra
+     * \f$ X_k, 0 \leq k \leq N/2 \f$, with \f$ X_k \f$ of transform b at
+     * k * batch + b
+     */
+    void forward_batch(int batch, const T *x, T *X_re, T *X_im) const {
+        if (batch == 1) {
+            forward(x, X_re, X_im);
+            return;
+        }
+        if (n % 2 != 0) {
+            for (int b = 0; b < batch; b++) {
+                for (int j = 0; j < n; j++) {
+                    work[j] = x[j * batch + b];
+                }
+                fft.forward(work.data(), work.data());
+                for (int k = 0; k <= n / 2; k++) {
+                    X_re[k * batch + b] = work[k].real();
+                    X_im[k * batch + b] = work[k].imag();
+                }
+            }
+            return;
+        }
+        const int h = n / 2;
+        if (zr.size() < static_cast<size_t>(h) * batch) {
+            zr.resize(static_cast<size_t>(h) * batch);
+            zi.resize(static_cast<size_t>(h) * batch);
+        }
+        T *z_re = zr.data(), *z_im = zi.data();
+        for (int j = 0; j < h; j++) {
+            for (int b = 0; b < batch; b++) {
+                z_re[j * batch + b] = x[2 * j * batch + b];
+                z_im[j * batch + b] = x[(2 * j + 1) * batch + b];
+            }
+        }
+        fft.forward_batch(batch, z_re, z_im, z_re, z_im);
+        for (int b = 0; b < batch; b++) {
+            X_re[b] = z_re[b] + z_im[b];
+            X_im[b] = 0;
+            X_re[h * batch + b] = z_re[b] - z_im[b];
+            X_im[h * batch + b] = 0;
+        }
+        for (int k = 1; k < h; k++) {
+            const T *ar = z_re + k * batch, *ai = z_im + k * batch;
+            const T *cr = z_re + (h - k) * batch, *ci = z_im + (h - k) * batch;
+            T *yr = X_re + k * batch, *yi = X_im + k * batch;
+#pragma GCC ivdep
+            for (int b = 0; b < batch; b++) {
+                // Spectra of the even (E) and odd (O) samples
+                const T Er = T(0.5) * (ar[b] + cr[b]);
+                const T Ei = T(0.5) * (ai[b] - ci[b]);
+                const T Or = T(0.5) * (ai[b] + ci[b]);
+                const T Oi = T(0.5) * (cr[b] - ar[b]);
+                yr[b] = Er + wr[k] * Or - wi[k] * Oi;
+                yi[b] = Ei + wr[k] * Oi + wi[k] * Or;
+            }
+        }
+    };
+
+    /**
+     * @brief Inverse transform (without normalization)
+     * @param X Spectrum \f$ X_k, 0 \leq k \leq N/2 \f$
+     * @param x Real data \f$ x_j = \sum_{k=0}^{N-1} X_k e^{2\pi i jk/N} \f$
+     * with the remaining coefficients given by Hermitian symmetry
+     */
+    void inverse(const complex *X, T *x) const {
+        apply_inverse(
+            [X](int k, T &re, T &im) {
+                re = X[k].real();
+                im = X[k].imag();
+            },
+            x);
+    };
+
+    /**
+     * @brief Inverse transform (without normalization) with split input
+     * @param X_re, X_im Real and imaginary parts of the spectrum
+     * \f$ X_k, 0 \leq k \leq N/2 \f$
+     * @param x Real data (see inverse)
+     */
+    void inverse(const T *X_re, const T *X_im, T *x) const {
+        apply_inverse(
+            [X_re, X_im](int k, T &re, T &im) {
+                re = X_re[k];
+                im = X_im[k];
+            },
+            x);
+    };
+
+    /**
+     * @brief Getter for length of the transform
+     */
+    int get_n() const { return n; };
+};
+
+typedef BasicRealFft<double> RealFft;
+
+#endif // _FFT_HPP_
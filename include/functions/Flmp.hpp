@@ -9,14 +9,23 @@
  * @date 2025-02-17
  */
 
+#include "Buffer.hpp"
+#include "Fft.hpp"
 #include "Plm.hpp"
+#include "PlmBatch.hpp"
+#include "Scalar.hpp"
+#include "ThreadPool.hpp"
 
-#include <Eigen/Dense>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
-#include <fft>
+#include <complex>
+#include <functional>
+#include <memory>
+#include <vector>
 
 /**
- * @class Flmp
+ * @class BasicFlmp
  *
  * @brief Class that computes and stores the normalized inclination functions
  * and its derivatives at a given inclination.
@@ -28,19 +37,55 @@
  * w.r.t. the inclination in order to compute the derivatives of the inclination
  * function.
  *
+ * The ALFs along the great circle are produced and consumed one order at a
+ * time (see PlmColumn in PlmBatch.hpp), so the working set of the computation
+ * is a single ALF column per sample and the peak memory is dominated by the
+ * output table. Within an order, the degrees are analysed in blocks of
+ * transforms applied at once (see BasicRealFft::forward_batch), which
+ * amortizes the passes of the short FFTs of low degrees over the block and
+ * vectorizes across degrees.
+ *
+ * The potential of degree l repeats itself with sign \f$ (-1)^l \f$ at the
+ * antipodes of the great circle, so it is only sampled over half of it and
+ * the blocks gather degrees of the same parity: even degrees are analysed
+ * with a real FFT of half the length, and odd degrees with a complex FFT of
+ * a quarter of the length. The number of samples is the smallest multiple of
+ * four above \f$ 2l_{max} \f$ with no prime factors other than 2, 3, 5 and
+ * 7, for which the FFTs run without padding (or a power of two, if it is at
+ * most 1/8 larger).
+ *
+ * When derivatives are requested, the potential and its derivative are
+ * sampled in the same pass over the ALF column, with the derivatives of the
+ * ALFs folded in from consecutive degrees, and are analysed together as the
+ * real and imaginary parts of a single complex FFT of half the length.
+ *
  * Further details on the normalization can also be found in Nlm.hpp
  *
  * The class enables two different formulations found in literature, both
  * \f$\bar{F}_{lmp}\f$ (e.g. Kaula, 1966) and \f$\bar{F}_{lmk}\f$ with
  * \f$k=l-2p\f$. The latter is more useful for gravity field spectral analysis.
  *
+ * The computation is carried out entirely in the scalar type T (see
+ * Scalar.hpp), including the FFT along the great circle (see Fft.hpp), so
+ * BasicFlmp<long double> or BasicFlmp<__float128> provide reference tables to
+ * assess the accuracy of the double precision Flmp.
+ *
  */
-class Flmp {
+template <typename T> class BasicFlmp {
+  public:
+    /**
+     * @brief Engines computing the inclination functions
+     */
+    enum Engine { FFT, Recursion };
+
+  private:
+    // Chebyshev tables fill their evaluations in place
+    template <typename> friend class BasicFlmpChebyshev;
 
     int l_max;
-    double I;
-    double *_Flmp;
-    double *_dFlmp;
+    T I;
+    BasicBuffer<T> _Flmp;  // Inclination functions
+    BasicBuffer<T> _dFlmp; // Inclination functions derivatives
 
     /**
      * Function that retrieves degree starting global index
@@ -49,7 +94,10 @@ class Flmp {
      *
      * @return Degree starting global storing index
      */
-    int l_idx(int l) { return (l * (l + 1) * (2 * l + 1)) / 6; }
+    static size_t l_idx(int l) {
+        const size_t L = l;
+        return (L * (L + 1) * (2 * L + 1)) / 6;
+    }
     /**
      * Function that retrieves global index for a given l,m,p set
      *
@@ -59,8 +107,8 @@ class Flmp {
      *
      * @return Global storing index associated to \f$\bar{F}_{lmp}\f$
      */
-    int lmp_idx(int l, int m, int p) const {
-        return (l + 1) * (l * (2 * l + 1)) / 6 + m * (l + 1) + p;
+    size_t lmp_idx(int l, int m, int p) const {
+        return l_idx(l) + static_cast<size_t>(m) * (l + 1) + p;
     };
 
     /**
@@ -72,216 +120,697 @@ class Flmp {
      *
      * @return Global storing index associated to \f$\bar{F}_{lmp}\f$
      */
-    int lmk_idx(int l, int m, int k) const {
+    size_t lmk_idx(int l, int m, int k) const {
         return lmp_idx(l, m, (l - k) / 2);
     };
 
-  public:
     /**
-     * Class default constructor
+     * Function that maps the spectrum of the unit disturbing potential along
+     * the great circle to the inclination functions of a given degree and
+     * order.
+     *
+     * The potential of degree l takes the values \f$ (-1)^l \f$ times its
+     * own at the antipodes, \f$ T(u+\pi) = (-1)^l T(u) \f$, so only the
+     * frequencies i of the parity of l are nonzero and they follow from the
+     * samples over half the great circle.
+     *
+     * @param y_re, y_im Real and imaginary parts of the spectrum of the unit
+     * disturbing potential over half the great circle, with frequency i at
+     * i/2 (rounded down)
+     * @param stride Stride between consecutive coefficients of the spectrum
+     * @param h Number of samples over half the great circle
+     * @param l degree
+     * @param m order
+     * @param F Inclination functions for p = 0, ..., l
      */
-    Flmp() : l_max(0), _Flmp(nullptr), _dFlmp(nullptr) {};
+    static void map_spectrum(const T *y_re, const T *y_im, int stride, int h,
+                             int l, int m, T *F) {
+        T C, S;
+        if (l % 2 == 0) {
+            C = 2 * y_re[0] / h;
+            F[l / 2] = m % 2 == 0 ? C : -C;
+        }
+        // Map coefficients Ci, Si to Flmp
+        for (int i = l % 2; i <= l; i += 2) {
+            C = 2 * y_re[i / 2 * stride] / h;
+            S = -2 * y_im[i / 2 * stride] / h;
+            if (l % 2 == m % 2) {
+                F[(l - i) / 2] = (C + S) / 2;
+                F[(l + i) / 2] = (C - S) / 2;
+            } else {
+                F[(l + i) / 2] = -(C + S) / 2;
+                F[(l - i) / 2] = -(C - S) / 2;
+            }
+        }
+    };
 
     /**
-     * Class constructor
-     * @param l_max Maximum degree to which the inclination functions (and its
-     * derivatives) will be computed
-     * @param I Inclination at which the inclination functions (and its
-     * derivatives) are evaluated
+     * @brief Inclination-independent setup of the FFT engine: sampling of the
+     * great circle, FFT plans and twiddles
+     */
+    struct Plan {
+        int q;                // Quarter of the number of samples
+        int h;                // Samples over half the great circle
+        T du;                 // Step
+        std::vector<T> sin_u; // Sine of the argument of latitude
+        std::vector<T> cos_u; // Cosine of the argument of latitude
+        std::vector<T> w_re;  // Pretwiddles of odd degrees
+        std::vector<T> w_im;
+        BasicRealFft<T> rfft; // Plan of even degrees (real data of length h)
+        BasicFft<T> fft;      // Plan of odd degrees (complex data of length q)
+        BasicFft<T> zfft;     // Plan of values and derivatives (length h)
+
+        /**
+         * Smallest number of samples resolving degree l_max (N > 2 l_max)
+         * that splits in quarters of a fast FFT length (see BasicFft). Powers
+         * of two within 1/8 of it are preferred, as radix-4 stages are faster
+         * @param l_max Maximum degree
+         * @return Quarter of the number of samples
+         */
+        static int quarter(int l_max) {
+            int q = BasicFft<T>::fast_size((2 * l_max + 4) / 4);
+            int q_2 = 1;
+            while (q_2 < q)
+                q_2 *= 2;
+            return 8 * q_2 <= 9 * q ? q_2 : q;
+        }
+
+        /**
+         * Class constructor
+         * @param l_max Maximum degree
+         */
+        Plan(int l_max)
+            : q(quarter(l_max)), h(2 * q), du(Scalar<T>::pi() / h),
+              sin_u(h), cos_u(h), w_re(h), w_im(h), rfft(h), fft(q),
+              zfft(h) {
+            for (int i = 0; i < h; i++) {
+                sin_u[i] = Scalar<T>::sin(du * i);
+                cos_u[i] = Scalar<T>::cos(du * i);
+            }
+            for (int r = 0; r < h; r++) {
+                w_re[r] = cos_u[r];
+                w_im[r] = -sin_u[r];
+            }
+        }
+    };
+
+    /**
+     * @brief Great circles of a group of tables, sampled one after the other
+     */
+    struct Group {
+        BasicFlmp *const *F;  // Tables, allocated at their inclinations
+        int n_I;              // Number of tables
+        std::vector<T> lam;   // Longitudes of the samples
+        std::vector<T> theta; // Co-latitudes of the samples
+        // Derivatives w.r.t. inclination: of the longitudes, and of the
+        // co-latitudes times their cotangent and cosecant
+        std::vector<T> dlam_dI, cot_dtheta_dI, csc_dtheta_dI;
+
+        /**
+         * Class constructor
+         * @param plan Sampling and FFT plans
+         * @param F Tables of the group, allocated at their inclinations
+         * @param n_I Number of tables of the group
+         * @param compute_derivatives Flag to determine whether inclination
+         * functions derivatives shall be computed or not
+         */
+        Group(const Plan &plan, BasicFlmp *const *F, int n_I,
+              bool compute_derivatives)
+            : F(F), n_I(n_I), lam(n_I * plan.h), theta(n_I * plan.h) {
+            const int h = plan.h;
+            const std::vector<T> &sin_u = plan.sin_u, &cos_u = plan.cos_u;
+            // Define additional variables for derivatives
+            if (compute_derivatives) {
+                dlam_dI.resize(n_I * h);
+                cot_dtheta_dI.resize(n_I * h);
+                csc_dtheta_dI.resize(n_I * h);
+            }
+            for (int g = 0; g < n_I; g++) {
+                const T cos_I = Scalar<T>::cos(F[g]->I);
+                const T sin_I = Scalar<T>::sin(F[g]->I);
+                for (int i = 0; i < h; i++) {
+                    lam[g * h + i] =
+                        Scalar<T>::atan2(cos_I * sin_u[i], cos_u[i]);
+                    theta[g * h + i] = Scalar<T>::acos(sin_I * sin_u[i]);
+                }
+                if (!compute_derivatives)
+                    continue;
+                T tan_u, sin_theta2;
+                for (int i = 0; i < h; i++) {
+                    tan_u = sin_u[i] / cos_u[i];
+                    dlam_dI[g * h + i] =
+                        -sin_I * tan_u / (1 + cos_I * cos_I * tan_u * tan_u);
+                    // cos(theta) = sin(I) sin(u), and dtheta/dI =
+                    // -sin(u) cos(I) / sin(theta)
+                    sin_theta2 = 1 - sin_I * sin_I * sin_u[i] * sin_u[i];
+                    csc_dtheta_dI[g * h + i] =
+                        -sin_u[i] * cos_I / sin_theta2;
+                    cot_dtheta_dI[g * h + i] =
+                        sin_I * sin_u[i] * csc_dtheta_dI[g * h + i];
+                }
+            }
+        }
+    };
+
+    /**
+     * Function that runs the computation of the orders on every thread of a
+     * pool, or on the calling thread only without a pool. The threads take
+     * the next pending order from a shared counter, from the most expensive
+     * one (m = 0) to the cheapest, so the uneven work of the orders is
+     * balanced dynamically. Every order is computed by the same code
+     * whichever thread takes it, so the results do not depend on the number
+     * of threads.
+     * @param pool Thread pool (optional)
+     * @param orders Function computing the pending orders of a counter
+     */
+    static void
+    each_thread(ThreadPool *pool,
+                const std::function<void(std::atomic<int> &)> &orders) {
+        std::atomic<int> next_m{0};
+        if (!pool) {
+            orders(next_m);
+            return;
+        }
+        pool->run(pool->get_n_threads(), [&](int) { orders(next_m); });
+    };
+
+    /**
+     * Function that computes the inclination functions (and its derivatives)
+     * of a group of tables with the FFT of the unit disturbing potential along
+     * the great circle (Wagner, 1983), for the pending orders of a counter.
+     *
+     * A single ALF column runs the recursions along the great circles of all
+     * the inclinations of the group at once, and the lanes of the batched FFTs
+     * are shared among the inclinations of the group before the degrees of a
+     * block.
+     * @param shared Sampling and FFT plans
+     * @param group Great circles of the group, with at most as many tables as
+     * the batch of the real FFT plan
      * @param compute_derivatives Flag to determine whether inclination
      * functions derivatives shall be computed or not
+     * @param next_m Counter of pending orders
+     * @param concurrent Flag to indicate whether other threads compute orders
+     * of the group at the same time
      */
-    Flmp(int l_max, double I, bool compute_derivatives = false)
-        : l_max(l_max), I(I) {
-        // Allocate inclination functions
-        _Flmp = new double[l_idx(l_max + 1)];
-        // Compute inclination functions
-        // Determine great circle sampling
-        const int N = pow(2, ceil(log2(2 * l_max + 1))); // number of samples
-        double du = 2 * M_PI / N;                        // step
-        std::vector<double> u(N), lam(N), theta(N);
-        Eigen::VectorX<double> Tlm(N);
-        std::vector<Plm> plm;
-        plm.reserve(N);
-        double cos_I = cos(I);
-        double sin_I = sin(I);
-        std::vector<double> sin_u(N), cos_u(N);
-        for (int i = 0; i < N; i++) {
-            u[i] = du * i;
-            sin_u[i] = sin(u[i]);
-            cos_u[i] = cos(u[i]);
-            lam[i] = atan2(cos_I * sin_u[i], cos_u[i]);
-            theta[i] = acos(sin_I * sin_u[i]);
-            plm.emplace_back(l_max, theta[i], compute_derivatives);
+    static void wagner(const Plan &shared, const Group &group,
+                       bool compute_derivatives, std::atomic<int> &next_m,
+                       bool concurrent) {
+        int m = next_m++;
+        BasicFlmp *const *F = group.F;
+        const int l_max = F[0]->l_max, n_I = group.n_I;
+        if (m > l_max)
+            return;
+        // The FFT plans hold workspaces, so concurrent threads use copies
+        std::unique_ptr<Plan> copy;
+        if (concurrent)
+            copy.reset(new Plan(shared));
+        const Plan &plan = concurrent ? *copy : shared;
+        const int q = plan.q, h = plan.h;
+        const std::vector<T> &lam = group.lam;
+        const std::vector<T> &dlam_dI = group.dlam_dI;
+        const std::vector<T> &cot_dtheta = group.cot_dtheta_dI;
+        const std::vector<T> &csc_dtheta = group.csc_dtheta_dI;
+        // ALFs along the great circles are produced one order at a time.
+        // Their derivatives are folded into the samples of the derivative of
+        // the potential, so the column holds values only
+        BasicPlmColumn<T> plm(l_max, group.theta, false);
+        std::shared_ptr<const BasicPlmCoefficients<T>> coeffs =
+            BasicPlmCoefficients<T>::get(l_max);
+        // Samples and spectra of a block of degrees of each inclination,
+        // interleaved: lane g * D + j holds degree l1 + 2j of inclination g
+        const int batch = plan.rfft.get_batch();
+        const int D = std::max(1, batch / n_I);
+        std::vector<T> Tlm(h * batch), dTlm(h * batch);
+        std::vector<T> y_re((q + 1) * batch), y_im((q + 1) * batch);
+        std::vector<T> a_re(q * batch), a_im(q * batch);
+        std::vector<T> z_re, z_im, dy_re, dy_im;
+        if (compute_derivatives) {
+            z_re.resize(h * batch);
+            z_im.resize(h * batch);
+            dy_re.resize((q + 1) * batch);
+            dy_im.resize((q + 1) * batch);
         }
-        // Iterate over degree and order
-        std::vector<double> C(l_max + 1), S(l_max + 1);
-        Eigen::VectorX<std::complex<double>> y(N);
-        int l, m, i, lm = 0;
-        for (l = 0; l <= l_max; l++) {
-            for (m = 0; m <= l; m++) {
-                // Compute unit disturbing potential along great circle
-                for (i = 0; i < N; i++) {
-                    Tlm[i] = plm[i].get_Plm_bar(l, m) *
-                             (cos(m * lam[i]) + sin(m * lam[i]));
-                }
-                // Analyse perturbing potential with FFT
-                y = rfft(Tlm);
-                for (i = 0; i <= l; i++) {
-                    C[i] = 2 * y[i].real() / N;
-                    S[i] = -2 * y[i].imag() / N;
+        std::vector<T> cs_m(n_I * h), dcs_m(n_I * h);
+        /* Spectrum of a block of degrees of the same parity, interleaved. For
+         * even degrees it is the real FFT of the half circle. For odd degrees
+         * only odd frequencies 2k+1 survive, and their spectrum Z_k is
+         * Hermitian (Z_{h-1-k} = conj(Z_k)), so the even k = 2t are the FFT of
+         * length h/2 of W_N^r (x_r - i x_{r+h/2}) and the odd k are their
+         * conjugates (Z_{2t+1} = conj(Z_{h-2-2t})) */
+        const T *w_re = plan.w_re.data(), *w_im = plan.w_im.data();
+        auto spectrum = [&](int parity, const T *x) {
+            if (parity == 0) {
+                plan.rfft.forward_batch(batch, x, y_re.data(), y_im.data());
+                return;
+            }
+            for (int r = 0; r < q; r++) {
+                const T *x0 = x + r * batch, *x1 = x + (r + q) * batch;
+                for (int b = 0; b < batch; b++) {
+                    a_re[r * batch + b] = x0[b] * w_re[r] + x1[b] * w_im[r];
+                    a_im[r * batch + b] = x0[b] * w_im[r] - x1[b] * w_re[r];
                 }
-                // Map coefficients Ci, Si to Flmp
-                if (l % 2 == 0) {
-                    _Flmp[lm + l / 2] = m % 2 == 0 ? C[0] : -C[0];
+            }
+            plan.fft.forward_batch(batch, a_re.data(), a_im.data(),
+                                   a_re.data(), a_im.data());
+            for (int k = 0; k < q; k++) {
+                const int t = k / 2;
+                const int r = k % 2 == 0 ? t : q - 1 - t;
+                const T sign = k % 2 == 0 ? 1 : -1;
+                for (int b = 0; b < batch; b++) {
+                    y_re[k * batch + b] = a_re[r * batch + b];
+                    y_im[k * batch + b] = sign * a_im[r * batch + b];
                 }
-                if (l % 2 == m % 2) {
-                    for (i = 0; i <= l; i++) {
-                        if (i % 2 == l % 2) {
-                            _Flmp[lm + (l - i) / 2] = (C[i] + S[i]) / 2;
-                            _Flmp[lm + (l + i) / 2] = (C[i] - S[i]) / 2;
-                        }
-                    }
-                } else {
-                    for (i = 0; i <= l; i++) {
-                        if (i % 2 == l % 2) {
-                            _Flmp[lm + (l + i) / 2] = -(C[i] + S[i]) / 2;
-                            _Flmp[lm + (l - i) / 2] = -(C[i] - S[i]) / 2;
-                        }
+            }
+        };
+        /* Spectra of the potential and its derivative at once, with a single
+         * complex FFT of length h of Tlm + i dTlm (pretwiddled by W_N^r for
+         * odd degrees). The spectra of both real parts follow from the
+         * Hermitian symmetry of each of them: with Z'_k = conj(Z_{h-k}) for
+         * even degrees and conj(Z_{h-1-k}) for odd degrees,
+         * Y_k = (Z_k + Z'_k) / 2 and dY_k = (Z_k - Z'_k) / 2i */
+        auto spectra = [&](int parity) {
+            if (parity == 0) {
+                plan.zfft.forward_batch(batch, Tlm.data(), dTlm.data(),
+                                        z_re.data(), z_im.data());
+            } else {
+                for (int r = 0; r < h; r++) {
+                    const T *x = Tlm.data() + r * batch;
+                    const T *dx = dTlm.data() + r * batch;
+                    for (int b = 0; b < batch; b++) {
+                        z_re[r * batch + b] = x[b] * w_re[r] - dx[b] * w_im[r];
+                        z_im[r * batch + b] = x[b] * w_im[r] + dx[b] * w_re[r];
                     }
                 }
-                lm += (l + 1);
+                plan.zfft.forward_batch(batch, z_re.data(), z_im.data(),
+                                        z_re.data(), z_im.data());
             }
-        }
-        // Compute derivatives
-        if (compute_derivatives) {
-            // Allocate derivatives
-            _dFlmp = new double[l_idx(l_max + 1)];
-            // Define additional variables
-            Eigen::VectorX<double> dTlm(N);
-            std::vector<double> dtheta_dI(N), dlam_dI(N);
-            double tan_u;
-            for (int i = 0; i < N; i++) {
-                tan_u = sin_u[i] / cos_u[i];
-                dtheta_dI[i] = -sin_u[i] * cos_I /
-                               sqrt(1 - sin_I * sin_I * sin_u[i] * sin_u[i]);
-                dlam_dI[i] =
-                    -sin_I * tan_u / (1 + cos_I * cos_I * tan_u * tan_u);
+            for (int k = 0; k <= q - parity; k++) {
+                const int k_c = (h - k - parity) % h;
+                const T *Z_re = z_re.data() + k * batch;
+                const T *Z_im = z_im.data() + k * batch;
+                const T *Zc_re = z_re.data() + k_c * batch;
+                const T *Zc_im = z_im.data() + k_c * batch;
+                for (int b = 0; b < batch; b++) {
+                    y_re[k * batch + b] = (Z_re[b] + Zc_re[b]) / 2;
+                    y_im[k * batch + b] = (Z_im[b] - Zc_im[b]) / 2;
+                    dy_re[k * batch + b] = (Z_im[b] + Zc_im[b]) / 2;
+                    dy_im[k * batch + b] = (Zc_re[b] - Z_re[b]) / 2;
+                }
             }
-            // Iterate over degree and order
-            lm = 0;
-            for (l = 0; l <= l_max; l++) {
-                for (m = 0; m <= l; m++) {
-                    // Compute unit disturbing potential derivative along great
-                    // circle
-                    for (i = 0; i < N; i++) {
-                        dTlm[i] =
-                            plm[i].get_dPlm_bar(l, m) * dtheta_dI[i] *
-                                (cos(m * lam[i]) + sin(m * lam[i])) +
-                            +plm[i].get_Plm_bar(l, m) *
-                                (-m * sin(m * lam[i]) + m * cos(m * lam[i])) *
-                                dlam_dI[i];
-                    }
-                    // Analyse perturbing potential with FFT
-                    y = rfft(dTlm);
-                    for (i = 0; i <= l; i++) {
-                        C[i] = 2 * y[i].real() / N;
-                        S[i] = -2 * y[i].imag() / N;
-                    }
-                    // Map coefficients Ci, Si to Flmp
-                    if (l % 2 == 0) {
-                        _dFlmp[lm + l / 2] = m % 2 == 0 ? C[0] : -C[0];
-                    }
-                    if (l % 2 == m % 2) {
-                        for (i = 0; i <= l; i++) {
-                            if (i % 2 == l % 2) {
-                                _dFlmp[lm + (l - i) / 2] = (C[i] + S[i]) / 2;
-                                _dFlmp[lm + (l + i) / 2] = (C[i] - S[i]) / 2;
+        };
+        for (; m <= l_max; m = next_m++) {
+            plm.seek(m);
+            // Longitude dependency for this order
+            for (int i = 0; i < n_I * h; i++) {
+                const T c = Scalar<T>::cos(m * lam[i]);
+                const T s = Scalar<T>::sin(m * lam[i]);
+                cs_m[i] = c + s;
+                dcs_m[i] = m * (c - s);
+            }
+            // Degrees of the same parity are analysed together
+            for (int l0 = m; l0 <= l_max; l0 += 2 * D) {
+                for (int l1 = l0; l1 <= l_max && l1 < l0 + 2; l1++) {
+                    const int n_l = std::min(D, (l_max - l1) / 2 + 1);
+                    if (compute_derivatives) {
+                        // Compute unit disturbing potential and its
+                        // derivative along great circles in a single pass,
+                        // with dP_lm = l cot P_lm - f_lm csc P_(l-1)m
+                        for (int g = 0; g < n_I; g++) {
+                            const int o = g * h; // First sample of the circle
+                            const T *cot = cot_dtheta.data() + o;
+                            const T *csc = csc_dtheta.data() + o;
+                            const T *cs = cs_m.data() + o;
+                            const T *dcs = dcs_m.data() + o;
+                            const T *dlam = dlam_dI.data() + o;
+                            for (int j = 0; j < n_l; j++) {
+                                const int l = l1 + 2 * j;
+                                const T *P = plm.get_Plm_bar(l) + o;
+                                const T *P_1 =
+                                    l > m ? plm.get_Plm_bar(l - 1) + o : P;
+                                const T f = l > m ? coeffs->get_f(l, m) : 0;
+                                T *x = Tlm.data() + g * D + j;
+                                T *dx = dTlm.data() + g * D + j;
+                                for (int i = 0; i < h; i++) {
+                                    x[i * batch] = P[i] * cs[i];
+                                    dx[i * batch] =
+                                        (l * cot[i] * P[i] -
+                                         f * csc[i] * P_1[i]) *
+                                            cs[i] +
+                                        P[i] * dcs[i] * dlam[i];
+                                }
                             }
                         }
+                        spectra(l1 % 2);
                     } else {
-                        for (i = 0; i <= l; i++) {
-                            if (i % 2 == l % 2) {
-                                _dFlmp[lm + (l + i) / 2] = -(C[i] + S[i]) / 2;
-                                _dFlmp[lm + (l - i) / 2] = -(C[i] - S[i]) / 2;
+                        // Compute unit disturbing potential along great
+                        // circles
+                        for (int g = 0; g < n_I; g++) {
+                            const T *cs = cs_m.data() + g * h;
+                            for (int j = 0; j < n_l; j++) {
+                                const T *P =
+                                    plm.get_Plm_bar(l1 + 2 * j) + g * h;
+                                T *x = Tlm.data() + g * D + j;
+                                for (int i = 0; i < h; i++) {
+                                    x[i * batch] = P[i] * cs[i];
+                                }
                             }
                         }
+                        spectrum(l1 % 2, Tlm.data());
+                    }
+                    // Map the spectra (unused lanes of the last block are
+                    // transformed along)
+                    for (int g = 0; g < n_I; g++) {
+                        BasicFlmp &flmp = *F[g];
+                        for (int j = 0; j < n_l; j++) {
+                            const int l = l1 + 2 * j, b = g * D + j;
+                            const size_t idx = flmp.lmp_idx(l, m, 0);
+                            map_spectrum(y_re.data() + b, y_im.data() + b,
+                                         batch, h, l, m, &flmp._Flmp[idx]);
+                            if (compute_derivatives)
+                                map_spectrum(dy_re.data() + b,
+                                             dy_im.data() + b, batch, h, l,
+                                             m, &flmp._dFlmp[idx]);
+                        }
                     }
-                    lm += (l + 1);
                 }
             }
-        } else {
-            _dFlmp = nullptr;
         }
-    }
+    };
 
     /**
-     * Copy assignment operator
+     * @brief Inclination-independent setup of the recursion engine
      */
-    Flmp &operator=(const Flmp &other) {
-        if (this != &other) {
-            // Copy basic attributes
-            I = other.I;
-            l_max = other.l_max;
-            // Assign inclination functions
-            if (other._Flmp != nullptr && other.l_max > 0) {
-                int size = l_idx(other.l_max + 1);
-                _Flmp = new double[size];
+    struct Wigner {
+        // Factors 1 / sqrt(l^2 - k^2) and sqrt((l-1)^2 - k^2) / sqrt(l^2 - k^2)
+        // shared by all orders, and magnitudes of the fully-normalized ALFs at
+        // the equator, with l, |k| stored at l (l + 1) / 2 + |k|
+        std::vector<T> r, q, P0;
 
-                for (int i = 0; i < size; ++i) {
-                    _Flmp[i] = other._Flmp[i];
+        /**
+         * Class constructor
+         * @param l_max Maximum degree
+         */
+        Wigner(int l_max)
+            : r((l_max + 1) * (l_max + 2) / 2), q(r.size()), P0(r.size()) {
+            BasicPlm<T> equator(l_max, Scalar<T>::pi() / 2);
+            for (int l = 0; l <= l_max; l++) {
+                for (int k = 0; k <= l; k++) {
+                    P0[l * (l + 1) / 2 + k] =
+                        Scalar<T>::fabs(equator.get_Plm_bar(l, k));
+                }
+            }
+            for (int l = 1; l <= l_max; l++) {
+                for (int k = 0; k < l; k++) {
+                    r[l * (l + 1) / 2 + k] =
+                        1 / Scalar<T>::sqrt(T(l * l - k * k));
+                    q[l * (l + 1) / 2 + k] =
+                        Scalar<T>::sqrt(T((l - 1) * (l - 1) - k * k)) *
+                        r[l * (l + 1) / 2 + k];
                 }
-            } else {
-                _Flmp = nullptr;
             }
-            // Assign inclination functions derivatives
-            if (other._dFlmp != nullptr && other.l_max > 0) {
-                int size = l_idx(other.l_max + 1);
-                _dFlmp = new double[size];
+        }
+    };
 
-                for (int i = 0; i < size; ++i) {
-                    _dFlmp[i] = other._dFlmp[i];
+    /**
+     * Function that computes the inclination functions (and its derivatives)
+     * with recursions of Wigner d-functions, for the pending orders of a
+     * counter.
+     *
+     * The unit disturbing potential along the great circle is a spherical
+     * harmonic rotated by the inclination and evaluated on the equator of
+     * the orbital frame, which yields
+     * \f[
+     * \bar{F}_{lmp}(I) = (-1)^{\lfloor (l-m)/2 \rfloor}
+     * \sqrt{\frac{2-\delta_{0m}}{2-\delta_{0k}}} |\bar{P}_{l|k|}(0)|
+     * d^l_{mk}(I), \quad k = l-2p
+     * \f]
+     * For each order, the d-functions of every k are carried along the
+     * three-term recursion in degree (e.g. Kostelec and Rockmore, 2008) row by
+     * row, so that the inner loop over k vectorizes. Each recursion starts at
+     * \f$ l = \max(m, |k|) \f$ from closed-form values, kept as X-numbers
+     * (see XNumber.hpp) while below the range of T.
+     *
+     * @param wigner Recursion factors and ALFs at the equator
+     * @param compute_derivatives Flag to determine whether inclination
+     * functions derivatives shall be computed or not
+     * @param next_m Counter of pending orders
+     */
+    void recursion(const Wigner &wigner, bool compute_derivatives,
+                   std::atomic<int> &next_m) {
+        typedef BasicXNumber<T> X;
+        int m = next_m++;
+        if (m > l_max)
+            return;
+        const T t = Scalar<T>::cos(I), u = Scalar<T>::sin(I);
+        const T c = Scalar<T>::cos(I / 2), s = Scalar<T>::sin(I / 2);
+        // Powers of the cosine and sine of the half inclination
+        std::vector<X> c_pow(2 * l_max + 2), s_pow(2 * l_max + 2);
+        c_pow[0] = s_pow[0] = X(1);
+        for (int j = 1; j < 2 * l_max + 2; j++) {
+            c_pow[j] = c_pow[j - 1] * c;
+            s_pow[j] = s_pow[j - 1] * s;
+        }
+        // Recursions at degrees l and l-1, with k stored at l_max + k
+        const int K = 2 * l_max + 1;
+        std::vector<T> d_1(K), d_2(K), dd_1(K), dd_2(K);
+        std::vector<X> x_1(K), x_2(K), dx_1(K), dx_2(K);
+        std::vector<char> extended(K);
+        std::vector<X> sqrt_C(K); // Square roots of binomial coefficients
+        // Closed-form start C c^alpha s^gamma of a recursion
+        auto seed = [&](int k, const X &C, int alpha, int gamma, T sign) {
+            const int i = l_max + k;
+            x_1[i] = C * c_pow[alpha] * s_pow[gamma] * sign;
+            x_2[i] = X(0);
+            dx_1[i] = dx_2[i] = X(0);
+            if (compute_derivatives) {
+                const X a = gamma > 0 ? C * c_pow[alpha + 1] * s_pow[gamma - 1]
+                                      : X(0);
+                const X b = alpha > 0 ? C * c_pow[alpha - 1] * s_pow[gamma + 1]
+                                      : X(0);
+                dx_1[i] = X::lsum2(sign * gamma / 2, a, -sign * alpha / 2, b);
+            }
+            d_1[i] = x_1[i].to_double();
+            dd_1[i] = dx_1[i].to_double();
+            d_2[i] = dd_2[i] = 0;
+            extended[i] = x_1[i].get_i() != 0 || dx_1[i].get_i() != 0;
+        };
+        for (; m <= l_max; m = next_m++) {
+            // Start of the recursions with |k| <= m
+            sqrt_C[0] = X(1);
+            for (int r = 0; r < 2 * m; r++) {
+                sqrt_C[r + 1] =
+                    sqrt_C[r] * Scalar<T>::sqrt(T(2 * m - r) / (r + 1));
+            }
+            for (int k = -m; k <= m; k++) {
+                seed(k, sqrt_C[m - k], m + k, m - k, (m - k) % 2 == 0 ? 1 : -1);
+            }
+            X C = X(1);
+            for (int l = m; l <= l_max; l++) {
+                if (l > m) {
+                    const T sm = Scalar<T>::sqrt(T(l * l - m * m));
+                    const T sm_1 =
+                        Scalar<T>::sqrt(T((l - 1) * (l - 1) - m * m));
+                    const T fa = l * (2 * l - 1) / sm;
+                    const T fb = l > 1 ? l * sm_1 / ((l - 1) * sm) : 0;
+                    const T fc = l > 1 ? T(m) / ((l - 1) * l) : 0;
+                    const T *r_l = wigner.r.data() + l * (l + 1) / 2;
+                    const T *q_l = wigner.q.data() + l * (l + 1) / 2;
+                    const int i0 = l_max - (l - 1), i1 = l_max + (l - 1);
+                    // Recursions with |k| < l
+                    for (int i = i0; i <= i1; i++) {
+                        const int k = i - l_max;
+                        const T e = fa * r_l[k < 0 ? -k : k];
+                        const T a = e * (t - fc * k);
+                        const T b = fb * q_l[k < 0 ? -k : k];
+                        const T d = a * d_1[i] - b * d_2[i];
+                        if (compute_derivatives) {
+                            const T dd = a * dd_1[i] - e * u * d_1[i] -
+                                         b * dd_2[i];
+                            dd_2[i] = dd_1[i];
+                            dd_1[i] = dd;
+                        }
+                        d_2[i] = d_1[i];
+                        d_1[i] = d;
+                    }
+                    // Recursions still below the range of doubles
+                    for (int i = i0; i <= i1; i++) {
+                        if (!extended[i])
+                            continue;
+                        const int k = i - l_max;
+                        const T e = fa * r_l[k < 0 ? -k : k];
+                        const T a = e * (t - fc * k);
+                        const T b = fb * q_l[k < 0 ? -k : k];
+                        const X x = X::lsum2(a, x_1[i], -b, x_2[i]);
+                        const X dx =
+                            X::lsum2(T(1), X::lsum2(a, dx_1[i], -b, dx_2[i]),
+                                     -e * u, x_1[i]);
+                        x_2[i] = x_1[i];
+                        x_1[i] = x;
+                        dx_2[i] = dx_1[i];
+                        dx_1[i] = dx;
+                        d_1[i] = x_1[i].to_double();
+                        d_2[i] = x_2[i].to_double();
+                        dd_1[i] = dx_1[i].to_double();
+                        dd_2[i] = dx_2[i].to_double();
+                        extended[i] = x_1[i].get_i() != 0 ||
+                                      x_2[i].get_i() != 0 ||
+                                      dx_1[i].get_i() != 0 ||
+                                      dx_2[i].get_i() != 0;
+                    }
+                    // Start of the recursions with |k| = l
+                    C = C * Scalar<T>::sqrt(T(2 * l) * (2 * l - 1) /
+                                            (T(l - m) * (l + m)));
+                    seed(l, C, l + m, l - m, 1);
+                    seed(-l, C, l - m, l + m, (l + m) % 2 == 0 ? 1 : -1);
+                }
+                // Map d-functions to inclination functions
+                const T sign = (l - m) / 2 % 2 == 0 ? 1 : -1;
+                for (int p = 0; p <= l; p++) {
+                    const int k = l - 2 * p;
+                    T g = sign * wigner.P0[l * (l + 1) / 2 + (k > 0 ? k : -k)];
+                    if (m > 0 && k == 0)
+                        g *= Scalar<T>::sqrt(2);
+                    else if (m == 0 && k != 0)
+                        g /= Scalar<T>::sqrt(2);
+                    _Flmp[lmp_idx(l, m, p)] = g * d_1[l_max + k];
+                    if (compute_derivatives)
+                        _dFlmp[lmp_idx(l, m, p)] = g * dd_1[l_max + k];
                 }
-            } else {
-                _dFlmp = nullptr;
             }
         }
-        return *this;
-    }
+    };
 
     /**
-     * Copy constructor
+     * Function that allocates the inclination functions tables.
+     * @param compute_derivatives Flag to determine whether inclination
+     * functions derivatives shall be computed or not
+     * @param storage Storage of the inclination functions tables
      */
-    Flmp(const Flmp &other)
-        : l_max(other.l_max), I(other.I), _Flmp(nullptr), _dFlmp(nullptr) {
-        // Assign inclination functions
-        if (other._Flmp != nullptr && other.l_max > 0) {
-            int size = l_idx(other.l_max + 1);
-            _Flmp = new double[size];
+    void allocate(bool compute_derivatives, const Storage &storage) {
+        _Flmp = BasicBuffer<T>(size(l_max), storage);
+        if (compute_derivatives)
+            _dFlmp = BasicBuffer<T>(size(l_max), storage);
+    };
 
-            for (int i = 0; i < size; ++i) {
-                _Flmp[i] = other._Flmp[i];
+    // Values of the ALF column of a group of inclinations (see batch)
+    static constexpr int group_samples = 1 << 14;
+
+    /**
+     * Function that computes the inclination functions (and its derivatives)
+     * of tables allocated to the same degree, sharing the setup that does not
+     * depend on the inclination.
+     * @param F Tables, allocated at their inclinations
+     * @param n Number of tables
+     * @param compute_derivatives Flag to determine whether inclination
+     * functions derivatives shall be computed or not
+     * @param engine Engine computing the inclination functions
+     * @param pool Thread pool (optional)
+     */
+    static void compute(BasicFlmp *const *F, int n, bool compute_derivatives,
+                        Engine engine, ThreadPool *pool) {
+        const int l_max = F[0]->l_max;
+        if (engine == Recursion) {
+            const Wigner wigner(l_max);
+            for (int j = 0; j < n; j++) {
+                each_thread(pool, [&](std::atomic<int> &next_m) {
+                    F[j]->recursion(wigner, compute_derivatives, next_m);
+                });
             }
+            return;
         }
-        // Assign inclination functions derivatives
-        if (other._dFlmp != nullptr && other.l_max > 0) {
-            int size = l_idx(other.l_max + 1);
-            _dFlmp = new double[size];
+        const Plan plan(l_max);
+        const bool concurrent = pool && pool->get_n_threads() > 1;
+        // Groups of inclinations fill the lanes of the batched FFTs, as long
+        // as the ALF column of a group spans at most group_samples values
+        const int size =
+            std::min(plan.rfft.get_batch(),
+                     std::max(1, group_samples / (plan.h * (l_max + 1))));
+        for (int j = 0; j < n; j += size) {
+            const Group group(plan, F + j, std::min(size, n - j),
+                              compute_derivatives);
+            each_thread(pool, [&](std::atomic<int> &next_m) {
+                wagner(plan, group, compute_derivatives, next_m, concurrent);
+            });
+        }
+    };
 
-            for (int i = 0; i < size; ++i) {
-                _dFlmp[i] = other._dFlmp[i];
-            }
+  public:
+    /**
+     * Class default constructor
+     */
+    BasicFlmp() : l_max(0) {};
+
+    /**
+     * Class constructor
+     * @param l_max Maximum degree to which the inclination functions (and its
+     * derivatives) will be computed
+     * @param I Inclination at which the inclination functions (and its
+     * derivatives) are evaluated
+     * @param compute_derivatives Flag to determine whether inclination
+     * functions derivatives shall be computed or not
+     * @param storage Storage of the inclination functions tables (e.g. huge
+     * pages or file mappings for very high degrees)
+     * @param engine Engine computing the inclination functions
+     * @param pool Thread pool (optional) computing the orders in parallel,
+     * with results independent of the number of threads
+     */
+    BasicFlmp(int l_max, T I, bool compute_derivatives = false,
+              const Storage &storage = Storage(), Engine engine = FFT,
+              ThreadPool *pool = nullptr)
+        : l_max(l_max), I(I) {
+        allocate(compute_derivatives, storage);
+        BasicFlmp *self = this;
+        compute(&self, 1, compute_derivatives, engine, pool);
+    }
+
+    /**
+     * Function that computes the inclination functions (and its derivatives)
+     * at several inclinations to the same degree.
+     *
+     * The setup that does not depend on the inclination is done once and
+     * shared by all the tables: the sampling of the great circle and the FFT
+     * plans of the FFT engine, and the recursion factors and equatorial ALFs
+     * of the recursion engine. Besides, the FFT engine analyses groups of
+     * inclinations together: the ALF recursions along their great circles
+     * run at once, and each batched FFT transforms the same degree at every
+     * inclination of the group, so that no lanes are left unused at the high
+     * orders of low degree tables.
+     * @param l_max Maximum degree to which the inclination functions (and its
+     * derivatives) will be computed
+     * @param I Inclinations at which the inclination functions (and its
+     * derivatives) are evaluated
+     * @param compute_derivatives Flag to determine whether inclination
+     * functions derivatives shall be computed or not
+     * @param storage Storage of each of the inclination functions tables
+     * @param engine Engine computing the inclination functions
+     * @param pool Thread pool (optional) computing the orders of each table
+     * (or group of tables) in parallel
+     * @return Inclination functions tables, in the order of I
+     */
+    static std::vector<BasicFlmp> batch(int l_max, const std::vector<T> &I,
+                                        bool compute_derivatives = false,
+                                        const Storage &storage = Storage(),
+                                        Engine engine = FFT,
+                                        ThreadPool *pool = nullptr) {
+        std::vector<BasicFlmp> tables(I.size());
+        for (size_t j = 0; j < I.size(); j++) {
+            tables[j].l_max = l_max;
+            tables[j].I = I[j];
+            tables[j].allocate(compute_derivatives, storage);
         }
+        std::vector<BasicFlmp *> F(tables.size());
+        for (size_t j = 0; j < tables.size(); j++)
+            F[j] = &tables[j];
+        if (!F.empty())
+            compute(F.data(), F.size(), compute_derivatives, engine, pool);
+        return tables;
     }
 
     /**
-     * Destructor
+     * Number of inclination functions stored up to a given degree
+     * @param l_max Maximum degree
      */
-    ~Flmp() {
-        delete[] _Flmp;
-        if (_dFlmp)
-            delete[] _dFlmp;
-    };
+    static size_t size(int l_max) { return l_idx(l_max + 1); };
 
     /**
      * Getter for maximum degree computed
@@ -294,7 +823,7 @@ class Flmp {
      * @param p p-index
      * @return \f$\bar{F}_{lmp}\f$
      */
-    double get_Flmp(int l, int m, int p) const {
+    T get_Flmp(int l, int m, int p) const {
         return _Flmp[lmp_idx(l, m, p)];
     };
     /**
@@ -304,7 +833,7 @@ class Flmp {
      * @param k k-index
      * @return \f$\bar{F}_{lmk}\f$
      */
-    double get_Flmk(int l, int m, int k) const {
+    T get_Flmk(int l, int m, int k) const {
         return abs(k) > l ? 0 : _Flmp[lmk_idx(l, m, k)];
     };
     /**
@@ -314,7 +843,7 @@ class Flmp {
      * @param p k-index
      * @return \f$\bar{F}_{lmp}\f$
      */
-    double get_dFlmp(int l, int m, int p) const {
+    T get_dFlmp(int l, int m, int p) const {
         return _dFlmp[lmp_idx(l, m, p)];
     };
     /**
@@ -324,7 +853,7 @@ class Flmp {
      * @param k k-index
      * @return \f$\bar{F}_{lmk}\f$
      */
-    double get_dFlmk(int l, int m, int k) const {
+    T get_dFlmk(int l, int m, int k) const {
         return abs(k) > l ? 0 : _dFlmp[lmk_idx(l, m, k)];
     };
     /**
@@ -334,12 +863,16 @@ class Flmp {
      * @param k k-index
      * @return \f$\bar{F}_{lmk}\f$
      */
-    double get_Flmk_star(int l, int m, int k) const {
-        return 0.5 *
-               (((k - 1) * cos(I) - m) / sin(I) * this->get_Flmk(l, m, k - 1) +
-                ((k + 1) * cos(I) - m) / sin(I) * this->get_Flmk(l, m, k + 1) +
+    T get_Flmk_star(int l, int m, int k) const {
+        const T cos_I = Scalar<T>::cos(I);
+        const T sin_I = Scalar<T>::sin(I);
+        return T(0.5) *
+               (((k - 1) * cos_I - m) / sin_I * this->get_Flmk(l, m, k - 1) +
+                ((k + 1) * cos_I - m) / sin_I * this->get_Flmk(l, m, k + 1) +
                 -this->get_dFlmk(l, m, k - 1) + this->get_dFlmk(l, m, k + 1));
     };
 };
 
+typedef BasicFlmp<double> Flmp;
+
 #endif //_FLMP_HPP_
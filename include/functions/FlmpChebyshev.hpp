@@ -0,0 +1,385 @@
+/**
+ * @file FlmpChebyshev.hpp
+ *
+ * @brief Header file to define Chebyshev interpolation tables of inclination
+ * functions
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _FLMP_CHEBYSHEV_HPP_
+#define _FLMP_CHEBYSHEV_HPP_
+
+#include "Buffer.hpp"
+#include "Fft.hpp"
+#include "Flmp.hpp"
+#include "Scalar.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @class BasicFlmpChebyshev
+ *
+ * @brief Class that stores Chebyshev expansions of the normalized inclination
+ * functions (and its derivatives) over an interval of inclinations.
+ *
+ * Every \f$\bar{F}_{lmp}\f$ is a trigonometric polynomial of degree l in the
+ * inclination, so its Chebyshev expansion in \f$ x = (2I - I_{min} -
+ * I_{max}) / (I_{max} - I_{min}) \f$ converges faster than geometrically.
+ * The expansions are obtained by interpolation at the Chebyshev points of
+ * the second kind \f$ x_j = \cos(\pi j / N) \f$, whose coefficients follow
+ * from a DCT-I, i.e. a real FFT of length 2N of the even extension of the
+ * values (see Fft.hpp). The tables at the points are built with the
+ * recursion engine of BasicFlmp, which is free of singularities inside
+ * \f$ [0, \pi] \f$.
+ *
+ * N starts at 16 and is doubled, reusing the tables at the previous points,
+ * until every expansion is resolved: the coefficients above some degree K
+ * with \f$ K \leq N/2 \f$ add up to at most half the tolerance. The series
+ * are truncated at the K of each degree (as the functions of low degrees
+ * need fewer coefficients), so evaluating the table at an inclination costs
+ * \f$ O((K+1) \cdot \f$ Flmp::size\f$ ) \f$ at most.
+ * As the upper half of the interpolant coefficients has decayed below the
+ * tolerance, the aliasing of the coefficients above N is negligible, and
+ * the error of the evaluated functions (and derivatives, if computed) is
+ * within the tolerance over the whole interval.
+ *
+ * Coefficient k of all the functions of a degree is contiguous in memory,
+ * so the evaluation is a sequence of vectorized updates of the output table.
+ *
+ * @tparam T Scalar type of the tables (see Scalar.hpp)
+ */
+template <typename T> class BasicFlmpChebyshev {
+    int l_max;                  // Maximum degree
+    T I_min;                    // Lower bound of the interval of inclinations
+    T I_max;                    // Upper bound of the interval of inclinations
+    T tolerance;                // Absolute accuracy target
+    size_t S;                   // Number of functions
+    std::vector<int> n;         // Number of coefficients of each degree
+    std::vector<size_t> offset; // First coefficient of each degree
+    BasicBuffer<T> _c;          // Coefficients (see coefficient)
+    BasicBuffer<T> _dc;         // Coefficients of the derivatives
+
+    // Maximum number of interpolation points
+    static constexpr int N_max = 1024;
+
+    /**
+     * Function that retrieves the index of a Chebyshev coefficient. The
+     * coefficients of a degree are stored after those of the lower degrees,
+     * with coefficient k of its \f$ (l+1)^2 \f$ functions contiguous.
+     * @param l Degree
+     * @param k Coefficient
+     * @param i Function of the degree, in the order of the Flmp table
+     * @return Index of the coefficient
+     */
+    size_t coefficient(int l, int k, int i) const {
+        return offset[l] + static_cast<size_t>(k) * (l + 1) * (l + 1) + i;
+    };
+
+    /**
+     * Function that computes the Chebyshev coefficients of a block of
+     * functions from their values at the points \f$ x_j = \cos(\pi j / N)
+     * \f$.
+     * @param rfft Real FFT plan of length 2N
+     * @param F Values of the functions at the points
+     * @param i0 First function of the block
+     * @param B Number of functions of the block (at most the batch of the
+     * plan)
+     * @param x, X_re, X_im Workspaces of 2N * batch values
+     * @param c Coefficients, with coefficient k of function i0 + b at
+     * k * batch + b
+     */
+    static void coefficients(const BasicRealFft<T> &rfft,
+                             const std::vector<const T *> &F, int i0,
+                             int B, std::vector<T> &x, std::vector<T> &X_re,
+                             std::vector<T> &X_im, T *c) {
+        const int N = F.size() - 1;
+        const int batch = rfft.get_batch();
+        // Even extension of the values (unused lanes are zeroed)
+        for (int j = 0; j < 2 * N; j++) {
+            const T *F_j = F[j <= N ? j : 2 * N - j] + i0;
+            for (int b = 0; b < batch; b++) {
+                x[j * batch + b] = b < B ? F_j[b] : 0;
+            }
+        }
+        rfft.forward_batch(batch, x.data(), X_re.data(), X_im.data());
+        for (int k = 0; k <= N; k++) {
+            const T w = (k == 0 || k == N) ? T(1) / (2 * N) : T(1) / N;
+            for (int b = 0; b < batch; b++) {
+                c[k * batch + b] = w * X_re[k * batch + b];
+            }
+        }
+    };
+
+    /**
+     * Function that accumulates the largest tails of a block of expansions.
+     * @param c Coefficients of the block, as given by coefficients
+     * @param N Degree of the expansions
+     * @param batch Stride of the coefficients
+     * @param B Number of functions of the block
+     * @param tail Largest sum of the coefficients above degree K at K
+     */
+    static void tails(const T *c, int N, int batch, int B,
+                      std::vector<T> &tail) {
+        for (int b = 0; b < B; b++) {
+            T sum = 0;
+            for (int k = N; k > 0; k--) {
+                sum += Scalar<T>::fabs(c[k * batch + b]);
+                tail[k - 1] = std::max(tail[k - 1], sum);
+            }
+        }
+    };
+
+  public:
+    /**
+     * Default constructor
+     */
+    BasicFlmpChebyshev() : l_max(0), S(0) {};
+
+    /**
+     * Class constructor
+     * @param l_max Maximum degree to which the inclination functions (and its
+     * derivatives) will be expanded
+     * @param I_min Lower bound of the interval of inclinations
+     * @param I_max Upper bound of the interval of inclinations
+     * @param tolerance Absolute accuracy target of the inclination functions
+     * (and its derivatives) over the interval
+     * @param compute_derivatives Flag to determine whether inclination
+     * functions derivatives shall be expanded or not
+     * @param storage Storage of the coefficients
+     * @param pool Thread pool (optional) building the tables at the points
+     */
+    BasicFlmpChebyshev(int l_max, T I_min, T I_max, T tolerance,
+                       bool compute_derivatives = false,
+                       const Storage &storage = Storage(),
+                       ThreadPool *pool = nullptr)
+        : l_max(l_max), I_min(I_min), I_max(I_max), tolerance(tolerance),
+          S(BasicFlmp<T>::size(l_max)) {
+        if (!(I_min < I_max))
+            throw std::invalid_argument(
+                "FlmpChebyshev: empty interval of inclinations");
+        // Tables at the points x_j = cos(pi j / N), refined until resolved
+        std::vector<BasicFlmp<T>> tables;
+        int N = 8;
+        std::vector<int> K;
+        while (K.empty()) {
+            N *= 2;
+            if (N > N_max)
+                throw std::runtime_error(
+                    "FlmpChebyshev: tolerance not attainable");
+            // New points only (the odd ones after a refinement)
+            const int step = tables.empty() ? 1 : 2;
+            std::vector<T> I;
+            for (int j = step - 1; j <= N; j += step) {
+                const T x = Scalar<T>::cos(Scalar<T>::pi() * j / N);
+                I.push_back((I_min + I_max + x * (I_max - I_min)) / 2);
+            }
+            std::vector<BasicFlmp<T>> added = BasicFlmp<T>::batch(
+                l_max, I, compute_derivatives, Storage(),
+                BasicFlmp<T>::Recursion, pool);
+            if (tables.empty()) {
+                tables = std::move(added);
+            } else {
+                // Previous points are the even points of the refined set
+                std::vector<BasicFlmp<T>> merged;
+                for (int j = 0; j <= N; j++)
+                    merged.push_back(std::move(j % 2 == 0 ? tables[j / 2]
+                                                          : added[j / 2]));
+                tables = std::move(merged);
+            }
+            K = resolve(tables, compute_derivatives);
+        }
+        // Store the coefficients of each degree l up to K[l]
+        n.resize(l_max + 1);
+        offset.resize(l_max + 2);
+        offset[0] = 0;
+        for (int l = 0; l <= l_max; l++) {
+            n[l] = K[l] + 1;
+            offset[l + 1] =
+                offset[l] + static_cast<size_t>(n[l]) * (l + 1) * (l + 1);
+        }
+        _c = BasicBuffer<T>(offset[l_max + 1], storage);
+        store(tables, false, _c);
+        if (compute_derivatives) {
+            _dc = BasicBuffer<T>(offset[l_max + 1], storage);
+            store(tables, true, _dc);
+        }
+    };
+
+    /**
+     * Function that evaluates the inclination functions (and its derivatives)
+     * in place at a given inclination. The table is (re)allocated if it does
+     * not match the maximum degree or the derivative flag of the expansions.
+     * @param I Inclination within the interval of the expansions
+     * @param flmp Inclination functions table
+     */
+    void evaluate(T I, BasicFlmp<T> &flmp) const {
+        const bool derivatives = _dc.size() > 0;
+        if (flmp.l_max != l_max || flmp._Flmp.size() != S)
+            flmp._Flmp = BasicBuffer<T>(S);
+        if (derivatives && flmp._dFlmp.size() != S)
+            flmp._dFlmp = BasicBuffer<T>(S);
+        if (!derivatives)
+            flmp._dFlmp = BasicBuffer<T>();
+        flmp.l_max = l_max;
+        flmp.I = I;
+        // Chebyshev polynomials at the inclination
+        const T x = (2 * I - I_min - I_max) / (I_max - I_min);
+        std::vector<T> T_k(get_n());
+        T_k[0] = 1;
+        if (T_k.size() > 1)
+            T_k[1] = x;
+        for (size_t k = 2; k < T_k.size(); k++)
+            T_k[k] = 2 * x * T_k[k - 1] - T_k[k - 2];
+        sum(T_k, _c, flmp._Flmp.data());
+        if (derivatives)
+            sum(T_k, _dc, flmp._dFlmp.data());
+    };
+
+    /**
+     * Function that evaluates the inclination functions (and its derivatives)
+     * at a given inclination.
+     * @param I Inclination within the interval of the expansions
+     * @return Inclination functions table
+     */
+    BasicFlmp<T> evaluate(T I) const {
+        BasicFlmp<T> flmp;
+        evaluate(I, flmp);
+        return flmp;
+    };
+
+    /**
+     * Getter for maximum degree expanded
+     */
+    int get_l_max() const { return l_max; };
+    /**
+     * Getter for lower bound of the interval of inclinations
+     */
+    T get_I_min() const { return I_min; };
+    /**
+     * Getter for upper bound of the interval of inclinations
+     */
+    T get_I_max() const { return I_max; };
+    /**
+     * Getter for absolute accuracy target
+     */
+    T get_tolerance() const { return tolerance; };
+    /**
+     * Getter for number of Chebyshev coefficients of the functions of a degree
+     * @param l Degree
+     */
+    int get_n(int l) const { return n[l]; };
+    /**
+     * Getter for largest number of Chebyshev coefficients of a function
+     */
+    int get_n() const { return *std::max_element(n.begin(), n.end()); };
+
+  private:
+    /**
+     * Function that finds, for every degree l, the lowest degree K[l] at which
+     * the expansions of all its functions (and derivatives) are resolved.
+     * @param tables Tables at the points x_j = cos(pi j / N)
+     * @param derivatives Flag to indicate whether derivatives are checked
+     * @return Degrees K[l], or none if some expansion is not resolved
+     */
+    std::vector<int> resolve(const std::vector<BasicFlmp<T>> &tables,
+                             bool derivatives) const {
+        const int N = tables.size() - 1;
+        const BasicRealFft<T> rfft(2 * N);
+        const int batch = rfft.get_batch();
+        std::vector<T> x(2 * N * batch), X_re((N + 1) * batch),
+            X_im((N + 1) * batch), c((N + 1) * batch);
+        std::vector<int> K(l_max + 1);
+        for (int l = 0; l <= l_max; l++) {
+            const size_t first = BasicFlmp<T>::size(l - 1);
+            const int S_l = (l + 1) * (l + 1);
+            std::vector<T> tail(N + 1, 0);
+            for (int d = 0; d <= int(derivatives); d++) {
+                std::vector<const T *> F(N + 1);
+                for (int j = 0; j <= N; j++)
+                    F[j] = (d ? tables[j]._dFlmp.data()
+                              : tables[j]._Flmp.data()) +
+                           first;
+                for (int i0 = 0; i0 < S_l; i0 += batch) {
+                    const int B = std::min(batch, S_l - i0);
+                    coefficients(rfft, F, i0, B, x, X_re, X_im, c.data());
+                    tails(c.data(), N, batch, B, tail);
+                }
+            }
+            K[l] = 0;
+            while (tail[K[l]] > tolerance / 2)
+                K[l]++;
+            if (K[l] > N / 2)
+                return {};
+        }
+        return K;
+    };
+
+    /**
+     * Function that stores the coefficients up to the degrees of the table.
+     * @param tables Tables at the points x_j = cos(pi j / N)
+     * @param derivatives Flag to indicate whether the derivatives are stored
+     * @param out Coefficients (see coefficient)
+     */
+    void store(const std::vector<BasicFlmp<T>> &tables, bool derivatives,
+               BasicBuffer<T> &out) const {
+        const int N = tables.size() - 1;
+        const BasicRealFft<T> rfft(2 * N);
+        const int batch = rfft.get_batch();
+        std::vector<T> x(2 * N * batch), X_re((N + 1) * batch),
+            X_im((N + 1) * batch), c((N + 1) * batch);
+        for (int l = 0; l <= l_max; l++) {
+            const size_t first = BasicFlmp<T>::size(l - 1);
+            const int S_l = (l + 1) * (l + 1);
+            std::vector<const T *> F(N + 1);
+            for (int j = 0; j <= N; j++)
+                F[j] = (derivatives ? tables[j]._dFlmp.data()
+                                    : tables[j]._Flmp.data()) +
+                       first;
+            for (int i0 = 0; i0 < S_l; i0 += batch) {
+                const int B = std::min(batch, S_l - i0);
+                coefficients(rfft, F, i0, B, x, X_re, X_im, c.data());
+                for (int k = 0; k < n[l]; k++) {
+                    for (int b = 0; b < B; b++) {
+                        out[coefficient(l, k, i0 + b)] = c[k * batch + b];
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     * Function that sums the Chebyshev series of all the functions.
+     * @param T_k Chebyshev polynomials at the inclination
+     * @param c Coefficients
+     * @param F Values of the functions
+     */
+    void sum(const std::vector<T> &T_k, const BasicBuffer<T> &c, T *F) const {
+        for (int l = 0; l <= l_max; l++) {
+            const int S_l = (l + 1) * (l + 1);
+            T *F_l = F + BasicFlmp<T>::size(l - 1);
+            // Blocks of functions stay in cache across the coefficients
+            const int block = 1024;
+            for (int i0 = 0; i0 < S_l; i0 += block) {
+                const int i1 = std::min(S_l, i0 + block);
+                const T *c_0 = c.data() + coefficient(l, 0, 0);
+                for (int i = i0; i < i1; i++)
+                    F_l[i] = T_k[0] * c_0[i];
+                for (int k = 1; k < n[l]; k++) {
+                    const T *c_k = c.data() + coefficient(l, k, 0);
+                    const T t = T_k[k];
+                    for (int i = i0; i < i1; i++)
+                        F_l[i] += t * c_k[i];
+                }
+            }
+        }
+    };
+};
+
+typedef BasicFlmpChebyshev<double> FlmpChebyshev;
+
+#endif //_FLMP_CHEBYSHEV_HPP_
@@ -0,0 +1,392 @@
+/**
+ * @file Gravity.hpp
+ *
+ * @brief Header file to define the gravity potential, acceleration and
+ * gradient tensor of a spherical harmonic gravity field
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _GRAVITY_HPP_
+#define _GRAVITY_HPP_
+
+#include "Clm.hpp"
+#include "PlmBatch.hpp"
+#include "PlmCoefficients.hpp"
+
+#include <Eigen/Dense>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+/**
+ * @class Gravity
+ *
+ * @brief Class that evaluates the potential, acceleration and gravity gradient
+ * tensor of a spherical harmonic gravity field at Cartesian positions.
+ *
+ * The gravity potential is expressed in terms of the fully-normalized solid
+ * harmonics \f$ \bar{V}_{lm}, \bar{W}_{lm} \f$ (Cunningham, 1970; Montenbruck
+ * and Gill, 2000, sec. 3.2.4):
+ * \f[
+ * U = \frac{GM}{R} \sum_{l=0}^{L} \sum_{m=0}^{l} (\bar{C}_{lm} \bar{V}_{lm} +
+ * \bar{S}_{lm} \bar{W}_{lm}) \quad\quad \bar{V}_{lm} + i\bar{W}_{lm} =
+ * \left(\frac{R}{r}\right)^{l+1} \bar{P}_{lm}(\theta) e^{im\lambda}
+ * \f]
+ * Defining \f$ \xi = xR/r^2, \eta = yR/r^2, \zeta = zR/r^2, \rho = R^2/r^2
+ * \f$, the solid harmonics follow the same recursions as the ALFs (see
+ * Plm.hpp) starting from \f$ \bar{V}_{00} = R/r, \bar{W}_{00} = 0 \f$:
+ * \f[
+ * \bar{V}_{mm} + i\bar{W}_{mm} = s_m (\xi + i\eta) (\bar{V}_{m-1,m-1} +
+ * i\bar{W}_{m-1,m-1}) \quad\quad \bar{V}_{lm} = a_{lm} \zeta \bar{V}_{l-1,m} -
+ * b_{lm} \rho \bar{V}_{l-2,m}
+ * \f]
+ * The Cartesian derivatives of each term are combinations of the solid
+ * harmonics of the next degree, so the acceleration and the gradient tensor
+ * are obtained by applying those relations once or twice. The formulation
+ * only involves Cartesian coordinates and never divides by
+ * \f$ \sin{\theta} \f$, so it is free of singularities at the poles and
+ * branch-free in the inner loops.
+ *
+ * Positions and results are expressed in the body-fixed frame of the gravity
+ * field. An instance keeps its storage between evaluations, so evaluating at a
+ * new position never allocates memory. Accelerations can also be evaluated for
+ * a batch of positions at once (e.g. a constellation), vectorizing across
+ * positions.
+ */
+class Gravity {
+    int l_max;  // Maximum degree
+    double GM;  // Gravitational parameter
+    double R;   // Reference radius
+    Clm clm;    // Fully-normalized coefficients
+    std::shared_ptr<const PlmCoefficients> coeffs; // Recursion coefficients
+
+    std::vector<double> Kp; // Derivative factors towards order m+1
+    std::vector<double> Km; // Derivative factors towards order m-1
+    std::vector<double> Kz; // Derivative factors towards order m
+    std::vector<double> V;  // Fully-normalized solid harmonics (real part)
+    std::vector<double> W;  // Fully-normalized solid harmonics (imag part)
+
+    double U;          // Potential
+    Eigen::Vector3d a; // Acceleration
+    Eigen::Matrix3d T; // Gravity gradient tensor
+
+    // Workspace of batched evaluations (structure-of-arrays over positions)
+    std::vector<double> xi, eta, zeta, rho, r_inv; // Scaled coordinates
+    std::vector<double> V_col, W_col; // Solid harmonics of 3 orders
+    std::vector<double> ax, ay, az;   // Accelerations
+
+    /**
+     * Function that computes global index for internal data structure.
+     * @param l degree
+     * @param m order
+     * @return Global index
+     */
+    size_t lm_idx(int l, int m) const {
+        return (static_cast<size_t>(l) * (l + 1)) / 2 + m;
+    };
+
+    /**
+     * Function that contracts a pair of coefficients with the solid
+     * harmonics.
+     * @param l degree
+     * @param m order
+     * @param C cosine coefficient
+     * @param S sine coefficient
+     * @return \f$ C\bar{V}_{lm} + S\bar{W}_{lm} \f$
+     */
+    double contract(int l, int m, double C, double S) const {
+        return C * V[lm_idx(l, m)] + S * W[lm_idx(l, m)];
+    };
+
+    /**
+     * Function that applies the Cartesian derivative to a term
+     * \f$ C\bar{V}_{lm} + S\bar{W}_{lm} \f$. The result, scaled by \f$ R \f$,
+     * is a sum of terms \f$ C'\bar{V}_{l+1,m'} + S'\bar{W}_{l+1,m'} \f$, which
+     * are passed one by one to a callback.
+     * @param axis Cartesian axis (0, 1, 2 for x, y, z)
+     * @param l degree
+     * @param m order
+     * @param C cosine coefficient
+     * @param S sine coefficient
+     * @param emit Callback receiving \f$ m', C', S' \f$
+     */
+    template <typename F>
+    void derive(int axis, int l, int m, double C, double S, F &&emit) const {
+        const size_t lm = lm_idx(l, m);
+        if (axis == 2) {
+            emit(m, -Kz[lm] * C, -Kz[lm] * S);
+        } else if (m == 0) {
+            if (axis == 0)
+                emit(1, -Kp[lm] * C, 0.0);
+            else
+                emit(1, 0.0, -Kp[lm] * C);
+        } else if (axis == 0) {
+            emit(m + 1, -0.5 * Kp[lm] * C, -0.5 * Kp[lm] * S);
+            emit(m - 1, 0.5 * Km[lm] * C, 0.5 * Km[lm] * S);
+        } else {
+            emit(m + 1, 0.5 * Kp[lm] * S, -0.5 * Kp[lm] * C);
+            emit(m - 1, 0.5 * Km[lm] * S, -0.5 * Km[lm] * C);
+        }
+    };
+
+    /**
+     * Function that computes the solid harmonics of a given order at all
+     * positions of a batch, from the solid harmonics of the previous order.
+     * Rows are indexed by degree and padded to the batch stride.
+     * @param q order
+     * @param stride padded number of positions
+     */
+    void compute_column(int q, int stride) {
+        const int n_max = l_max + 1;
+        const size_t col = static_cast<size_t>(n_max + 1) * stride;
+        double *Vq = V_col.data() + (q % 3) * col;
+        double *Wq = W_col.data() + (q % 3) * col;
+        if (q == 0) {
+            for (int k = 0; k < stride; k++) {
+                Vq[k] = R * r_inv[k];
+                Wq[k] = 0;
+            }
+        } else {
+            // Sectorial terms
+            const double s = coeffs->get_s(q);
+            const double *Vp = V_col.data() + ((q - 1) % 3) * col;
+            const double *Wp = W_col.data() + ((q - 1) % 3) * col;
+            double *V_qq = Vq + static_cast<size_t>(q) * stride;
+            double *W_qq = Wq + static_cast<size_t>(q) * stride;
+            const double *V_pp = Vp + static_cast<size_t>(q - 1) * stride;
+            const double *W_pp = Wp + static_cast<size_t>(q - 1) * stride;
+            for (int k = 0; k < stride; k++) {
+                V_qq[k] = s * (xi[k] * V_pp[k] - eta[k] * W_pp[k]);
+                W_qq[k] = s * (xi[k] * W_pp[k] + eta[k] * V_pp[k]);
+            }
+        }
+        // Terms below the diagonal
+        for (int l = q + 1; l <= n_max; l++) {
+            const double c = coeffs->get_a(l, q);
+            const double d = l > q + 1 ? coeffs->get_b(l, q) : 0;
+            double *V_l = Vq + static_cast<size_t>(l) * stride;
+            double *W_l = Wq + static_cast<size_t>(l) * stride;
+            const double *V_1 = V_l - stride;
+            const double *W_1 = W_l - stride;
+            const double *V_2 = l > q + 1 ? V_1 - stride : V_1;
+            const double *W_2 = l > q + 1 ? W_1 - stride : W_1;
+            for (int k = 0; k < stride; k++) {
+                V_l[k] = c * zeta[k] * V_1[k] - d * rho[k] * V_2[k];
+                W_l[k] = c * zeta[k] * W_1[k] - d * rho[k] * W_2[k];
+            }
+        }
+    };
+
+  public:
+    /**
+     * Class constructor
+     * @param clm Fully-normalized coefficients of the gravity field
+     * @param GM Gravitational parameter
+     * @param R Reference radius of the coefficients
+     * @param l_max Maximum degree used in the evaluations (defaults to the
+     * maximum degree of the coefficients)
+     */
+    Gravity(const Clm &clm, double GM, double R, int l_max = -1)
+        : l_max(l_max < 0 ? clm.get_l_max() : l_max), GM(GM), R(R), clm(clm),
+          coeffs(PlmCoefficients::get(this->l_max + 2)), U(0),
+          a(Eigen::Vector3d::Zero()), T(Eigen::Matrix3d::Zero()) {
+        // Normalized factors of the derivatives (Montenbruck and Gill, 2000,
+        // eq. 3.33) up to the degree required by the gradient tensor
+        const size_t size = lm_idx(this->l_max + 2, 0);
+        Kp.resize(size);
+        Km.resize(size);
+        Kz.resize(size);
+        for (int l = 0; l <= this->l_max + 1; l++) {
+            const double q = (2 * l + 1.0) / (2 * l + 3);
+            for (int m = 0; m <= l; m++) {
+                const double d_m = m == 0 ? 0.5 : 1;
+                const double d_m1 = m == 1 ? 2 : 1;
+                Kp[lm_idx(l, m)] = sqrt(d_m * q * (l + m + 1.0) * (l + m + 2));
+                Km[lm_idx(l, m)] =
+                    m > 0 ? sqrt(d_m1 * q * (l - m + 1.0) * (l - m + 2)) : 0;
+                Kz[lm_idx(l, m)] = sqrt(q * (l - m + 1.0) * (l + m + 1));
+            }
+        }
+        V.resize(lm_idx(this->l_max + 3, 0));
+        W.resize(V.size());
+    };
+
+    /**
+     * @brief Evaluates the gravity field at a given position
+     * @param r Position in the body-fixed frame
+     * @param gradient Flag to indicate whether the gravity gradient tensor is
+     * computed or not
+     */
+    void evaluate(const Eigen::Vector3d &r, bool gradient = false) {
+        // Degree of the solid harmonics required
+        const int n_max = l_max + (gradient ? 2 : 1);
+        const double r2 = r.squaredNorm();
+        const double xi = r[0] * R / r2;
+        const double eta = r[1] * R / r2;
+        const double zeta = r[2] * R / r2;
+        const double rho = R * R / r2;
+        // Solid harmonics
+        V[0] = R / sqrt(r2);
+        W[0] = 0;
+        for (int m = 0; m <= n_max; m++) { // Fix order
+            if (m > 0) {
+                // Sectorial terms
+                const double s = coeffs->get_s(m);
+                const size_t mm = lm_idx(m, m);
+                const size_t mm_1 = lm_idx(m - 1, m - 1);
+                V[mm] = s * (xi * V[mm_1] - eta * W[mm_1]);
+                W[mm] = s * (xi * W[mm_1] + eta * V[mm_1]);
+            }
+            if (m == n_max)
+                break;
+            // Terms right below the diagonal
+            double c = coeffs->get_a(m + 1, m) * zeta;
+            V[lm_idx(m + 1, m)] = c * V[lm_idx(m, m)];
+            W[lm_idx(m + 1, m)] = c * W[lm_idx(m, m)];
+            // Other terms
+            for (int l = m + 2; l <= n_max; l++) {
+                c = coeffs->get_a(l, m) * zeta;
+                const double d = coeffs->get_b(l, m) * rho;
+                const size_t lm = lm_idx(l, m);
+                const size_t lm_1 = lm_idx(l - 1, m);
+                const size_t lm_2 = lm_idx(l - 2, m);
+                V[lm] = c * V[lm_1] - d * V[lm_2];
+                W[lm] = c * W[lm_1] - d * W[lm_2];
+            }
+        }
+        // Potential, acceleration and gradient
+        double sum = 0;
+        double acc[3] = {0, 0, 0};
+        double grad[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+        for (int l = 0; l <= l_max; l++) {
+            for (int m = 0; m <= l; m++) {
+                const double C = clm.get_C(l, m);
+                const double S = clm.get_S(l, m);
+                sum += contract(l, m, C, S);
+                for (int i = 0; i < 3; i++) {
+                    derive(i, l, m, C, S, [&](int m1, double C1, double S1) {
+                        acc[i] += contract(l + 1, m1, C1, S1);
+                        if (!gradient)
+                            return;
+                        for (int j = i; j < 3; j++) {
+                            derive(j, l + 1, m1, C1, S1,
+                                   [&](int m2, double C2, double S2) {
+                                       grad[i][j] +=
+                                           contract(l + 2, m2, C2, S2);
+                                   });
+                        }
+                    });
+                }
+            }
+        }
+        U = GM / R * sum;
+        for (int i = 0; i < 3; i++) {
+            a[i] = GM / (R * R) * acc[i];
+            for (int j = i; j < 3; j++) {
+                T(i, j) = T(j, i) = GM / (R * R * R) * grad[i][j];
+            }
+        }
+    };
+
+    /**
+     * @brief Evaluates the gravity acceleration at a batch of positions
+     *
+     * The recursions of the solid harmonics and the summations are carried
+     * out for all positions at once in a structure-of-arrays layout, so that
+     * the inner loops run over positions and vectorize, and every coefficient
+     * is loaded once per batch. Solid harmonics are produced one order at a
+     * time, keeping only the three orders involved in the acceleration. The
+     * workspace is kept between calls and only grows with the batch size.
+     * @param r Positions in the body-fixed frame
+     * @param acc Accelerations at each position (resized if needed)
+     */
+    void evaluate(const std::vector<Eigen::Vector3d> &r,
+                  std::vector<Eigen::Vector3d> &acc) {
+        const int n = r.size();
+        const int lanes = PlmBatch::lanes;
+        const int stride = ((n + lanes - 1) / lanes) * lanes;
+        const int n_max = l_max + 1;
+        const size_t col = static_cast<size_t>(n_max + 1) * stride;
+        // Allocate workspace
+        if (xi.size() < static_cast<size_t>(stride)) {
+            for (auto *v : {&xi, &eta, &zeta, &rho, &r_inv, &ax, &ay, &az})
+                v->resize(stride);
+            V_col.resize(3 * col);
+            W_col.resize(3 * col);
+        }
+        // Scaled coordinates (padding positions on the x axis)
+        for (int k = 0; k < stride; k++) {
+            const Eigen::Vector3d p = k < n ? r[k] : Eigen::Vector3d(R, 0, 0);
+            const double r2 = p.squaredNorm();
+            xi[k] = p[0] * R / r2;
+            eta[k] = p[1] * R / r2;
+            zeta[k] = p[2] * R / r2;
+            rho[k] = R * R / r2;
+            r_inv[k] = 1 / sqrt(r2);
+            ax[k] = ay[k] = az[k] = 0;
+        }
+        compute_column(0, stride);
+        for (int m = 0; m <= l_max; m++) { // Fix order
+            compute_column(m + 1, stride);
+            const double *V_m = V_col.data() + (m % 3) * col;
+            const double *W_m = W_col.data() + (m % 3) * col;
+            const double *V_p = V_col.data() + ((m + 1) % 3) * col;
+            const double *W_p = W_col.data() + ((m + 1) % 3) * col;
+            const double *V_n = V_col.data() + ((m + 2) % 3) * col;
+            const double *W_n = W_col.data() + ((m + 2) % 3) * col;
+            for (int l = m; l <= l_max; l++) {
+                const size_t lm = lm_idx(l, m);
+                const size_t row = static_cast<size_t>(l + 1) * stride;
+                const double C = clm.get_C(l, m);
+                const double S = clm.get_S(l, m);
+                const double zC = Kz[lm] * C, zS = Kz[lm] * S;
+                if (m == 0) {
+                    const double pC = Kp[lm] * C;
+                    for (int k = 0; k < stride; k++) {
+                        ax[k] -= pC * V_p[row + k];
+                        ay[k] -= pC * W_p[row + k];
+                        az[k] -= zC * V_m[row + k];
+                    }
+                    continue;
+                }
+                // Order m-1 is stored where order m+2 will be computed
+                const double pC = 0.5 * Kp[lm] * C, pS = 0.5 * Kp[lm] * S;
+                const double mC = 0.5 * Km[lm] * C, mS = 0.5 * Km[lm] * S;
+                for (int k = 0; k < stride; k++) {
+                    ax[k] += -pC * V_p[row + k] - pS * W_p[row + k] +
+                             mC * V_n[row + k] + mS * W_n[row + k];
+                    ay[k] += -pC * W_p[row + k] + pS * V_p[row + k] -
+                             mC * W_n[row + k] + mS * V_n[row + k];
+                    az[k] -= zC * V_m[row + k] + zS * W_m[row + k];
+                }
+            }
+        }
+        acc.resize(n);
+        for (int k = 0; k < n; k++) {
+            acc[k] = GM / (R * R) * Eigen::Vector3d(ax[k], ay[k], az[k]);
+        }
+    };
+
+    /**
+     * @brief Getter for maximum degree
+     */
+    int get_l_max() const { return l_max; };
+
+    /**
+     * @brief Getter for gravity potential at the last evaluated position
+     */
+    double get_potential() const { return U; };
+
+    /**
+     * @brief Getter for gravity acceleration at the last evaluated position
+     */
+    const Eigen::Vector3d &get_acceleration() const { return a; };
+
+    /**
+     * @brief Getter for gravity gradient tensor at the last evaluated position
+     */
+    const Eigen::Matrix3d &get_gradient() const { return T; };
+};
+
+#endif // _GRAVITY_HPP_
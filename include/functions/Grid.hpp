@@ -0,0 +1,324 @@
+/**
+ * @file Grid.hpp
+ *
+ * @brief Header file to define spherical harmonic synthesis and analysis on
+ * regular grids
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _GRID_HPP_
+#define _GRID_HPP_
+
+#include "Clm.hpp"
+#include "Fft.hpp"
+#include "PlmBatch.hpp"
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+/**
+ * @class Grid
+ *
+ * @brief Class that transforms spherical harmonic expansions (see Clm.hpp) to
+ * values on a regular grid of the sphere and back.
+ *
+ * The grid is made of rings of constant co-latitude \f$ \theta_i \f$ with
+ * \f$ N_\lambda \f$ equally spaced longitudes \f$ \lambda_j = 2\pi j /
+ * N_\lambda \f$. For each ring, the expansion is split into Fourier terms:
+ * \f[
+ * f(\theta_i, \lambda_j) = \sum_{m=0}^{L} (A_m(\theta_i) \cos{m\lambda_j} +
+ * B_m(\theta_i) \sin{m\lambda_j}) \quad\quad A_m + iB_m = \sum_{l=m}^{L}
+ * (\bar{C}_{lm} + i\bar{S}_{lm}) \bar{P}_{lm}(\theta_i)
+ * \f]
+ * so the synthesis along longitude is a real inverse FFT per ring (see
+ * Fft.hpp). The analysis applies a forward FFT per ring followed by a
+ * quadrature in co-latitude:
+ * \f[
+ * \bar{C}_{lm} + i\bar{S}_{lm} = \frac{1}{2N_\lambda} \sum_{i} w_i
+ * \bar{P}_{lm}(\theta_i) \sum_{j} f(\theta_i, \lambda_j) e^{im\lambda_j}
+ * \f]
+ * which is exact for expansions up to the grid degree. Two grids are
+ * supported:
+ * - Gauss-Legendre: \f$ L+1 \f$ rings at the roots of \f$ P_{L+1}(\cos\theta)
+ * \f$ with the Gauss weights and \f$ 2L+1 \f$ longitudes.
+ * - Driscoll-Healy: \f$ N = 2L+2 \f$ equiangular rings \f$ \theta_i = \pi i/N
+ * \f$ (including the north pole) with \f$ 2N \f$ longitudes and the weights
+ * of Driscoll and Healy (1994):
+ * \f[
+ * w_i = \frac{4}{N} \sin{\theta_i} \sum_{k=0}^{N/2-1} \frac{\sin{(2k+1)
+ * \theta_i}}{2k+1}
+ * \f]
+ *
+ * The ALFs are produced one order at a time for a block of rings (see
+ * PlmColumn in PlmBatch.hpp), so the sums over degree are vectorized across
+ * rings and the ALFs of the whole grid are never stored. Both grids are
+ * symmetric about the equator, so the ALFs are only computed for the northern
+ * rings and the southern ones follow from the equatorial parity
+ * \f$ \bar{P}_{lm}(\pi-\theta) = (-1)^{l+m} \bar{P}_{lm}(\theta) \f$ by
+ * splitting the sums into even and odd \f$ l-m \f$ terms. This halves the
+ * cost of the ALFs and of the sums over degree.
+ */
+class Grid {
+  public:
+    /**
+     * @brief Grid types
+     */
+    enum Type { GaussLegendre, DriscollHealy };
+
+    /**
+     * @brief Grid values, stored ring by ring
+     */
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                          Eigen::RowMajor>
+        Values;
+
+  private:
+    typedef std::complex<double> complex;
+
+    static constexpr int block = 64; // Rings per ALF block
+
+    int l_max;                   // Maximum degree of the grid
+    Type type;                   // Grid type
+    int n_lat;                   // Number of rings
+    int n_lon;                   // Number of longitudes per ring
+    std::vector<double> theta;   // Co-latitudes of rings
+    std::vector<double> weights; // Quadrature weights of rings
+    int n_north;                 // Number of northern rings (and equator)
+    std::vector<int> mirror;     // Mirrored ring of northern rings (or -1)
+    RealFft fft;                 // Longitude transform plan
+
+    /**
+     * Function that computes the Gauss-Legendre nodes and weights by Newton
+     * iteration on \f$ P_{n}(\cos\theta) \f$ in terms of the co-latitude.
+     */
+    void gauss_legendre() {
+        const int n = n_lat;
+        for (int i = 0; i < (n + 1) / 2; i++) {
+            double th = M_PI * (i + 0.75) / (n + 0.5);
+            double dP = 0;
+            for (int iter = 0; iter < 100; iter++) {
+                const double t = cos(th);
+                double P_1 = 1, P = t;
+                for (int k = 2; k <= n; k++) {
+                    const double P_2 = P_1;
+                    P_1 = P;
+                    P = ((2 * k - 1) * t * P_1 - (k - 1) * P_2) / k;
+                }
+                // Derivative w.r.t. co-latitude
+                dP = n * (t * P - P_1) / sin(th);
+                const double dth = P / dP;
+                th -= dth;
+                if (std::fabs(dth) < 1e-15)
+                    break;
+            }
+            theta[i] = th;
+            theta[n - 1 - i] = M_PI - th;
+            weights[i] = weights[n - 1 - i] = 2 / (dP * dP);
+        }
+    };
+
+    /**
+     * Function that computes the Driscoll-Healy nodes and weights.
+     */
+    void driscoll_healy() {
+        const int n = n_lat;
+        for (int i = 0; i < n; i++) {
+            theta[i] = M_PI * i / n;
+            double sum = 0;
+            for (int k = 0; k < n / 2; k++) {
+                sum += sin((2 * k + 1) * theta[i]) / (2 * k + 1);
+            }
+            weights[i] = 4.0 / n * sin(theta[i]) * sum;
+        }
+    };
+
+    /**
+     * Function that sums the terms of a given order and equatorial parity
+     * for a block of rings.
+     * @param clm Spherical harmonic coefficients
+     * @param plm ALFs of the current order
+     * @param m order
+     * @param l_0 first degree
+     * @param L last degree
+     * @param n number of rings
+     * @param A Cosine sums
+     * @param B Sine sums
+     */
+    static void sum_parity(const Clm &clm, const PlmColumn &plm, int m,
+                           int l_0, int L, int n, double *A, double *B) {
+        std::fill(A, A + n, 0.0);
+        std::fill(B, B + n, 0.0);
+        for (int l = l_0; l <= L; l += 2) {
+            const double C = clm.get_C(l, m);
+            const double S = clm.get_S(l, m);
+            const double *P = plm.get_Plm_bar(l);
+            for (int k = 0; k < n; k++) {
+                A[k] += C * P[k];
+                B[k] += S * P[k];
+            }
+        }
+    };
+
+  public:
+    /**
+     * Class constructor
+     * @param l_max Maximum degree of the expansions on the grid
+     * @param type Grid type
+     */
+    Grid(int l_max, Type type = GaussLegendre)
+        : l_max(l_max), type(type),
+          n_lat(type == GaussLegendre ? l_max + 1 : 2 * l_max + 2),
+          n_lon(type == GaussLegendre ? 2 * l_max + 1 : 4 * l_max + 4),
+          theta(n_lat), weights(n_lat), fft(n_lon) {
+        if (type == GaussLegendre)
+            gauss_legendre();
+        else
+            driscoll_healy();
+        // Pair northern rings with their southern mirror
+        n_north = type == GaussLegendre ? (n_lat + 1) / 2 : n_lat / 2 + 1;
+        mirror.resize(n_north);
+        for (int i = 0; i < n_north; i++) {
+            const int j = type == GaussLegendre ? n_lat - 1 - i : n_lat - i;
+            mirror[i] = j > i && j < n_lat ? j : -1;
+        }
+    };
+
+    /**
+     * @brief Synthesis of an expansion on the grid. Terms above the grid
+     * degree are ignored.
+     * @param clm Spherical harmonic coefficients
+     * @return Values on the grid
+     */
+    Values synthesis(const Clm &clm) const {
+        const int L = std::min(l_max, clm.get_l_max());
+        const int h = n_lon / 2 + 1;
+        std::vector<complex> spectra(static_cast<size_t>(n_lat) * h, 0.0);
+        std::vector<double> A_e(block), A_o(block), B_e(block), B_o(block);
+        for (int i0 = 0; i0 < n_north; i0 += block) {
+            const int n = std::min(block, n_north - i0);
+            PlmColumn plm(L, std::vector<double>(theta.begin() + i0,
+                                                 theta.begin() + i0 + n));
+            for (int m = 0; m <= L; m++) {
+                if (m > 0)
+                    plm.next();
+                // Sums over even and odd l-m terms
+                sum_parity(clm, plm, m, m, L, n, A_e.data(), B_e.data());
+                sum_parity(clm, plm, m, m + 1, L, n, A_o.data(), B_o.data());
+                // Hermitian half-spectrum of each ring and its mirror
+                const double scale = m == 0 ? 1 : 0.5;
+                for (int k = 0; k < n; k++) {
+                    const int i = i0 + k;
+                    spectra[static_cast<size_t>(i) * h + m] =
+                        scale * complex(A_e[k] + A_o[k], -B_e[k] - B_o[k]);
+                    if (mirror[i] >= 0)
+                        spectra[static_cast<size_t>(mirror[i]) * h + m] =
+                            scale * complex(A_e[k] - A_o[k], B_o[k] - B_e[k]);
+                }
+            }
+        }
+        Values f(n_lat, n_lon);
+        for (int i = 0; i < n_lat; i++) {
+            fft.inverse(spectra.data() + static_cast<size_t>(i) * h,
+                        f.data() + static_cast<size_t>(i) * n_lon);
+        }
+        return f;
+    };
+
+    /**
+     * @brief Analysis of grid values
+     * @param f Values on the grid
+     * @return Spherical harmonic coefficients up to the grid degree
+     */
+    Clm analysis(const Values &f) const {
+        const int h = n_lon / 2 + 1;
+        std::vector<complex> spectra(static_cast<size_t>(n_lat) * h);
+        for (int i = 0; i < n_lat; i++) {
+            fft.forward(f.data() + static_cast<size_t>(i) * n_lon,
+                        spectra.data() + static_cast<size_t>(i) * h);
+        }
+        Clm clm(l_max);
+        // Weighted Fourier terms of each ring plus (e) or minus (o) its mirror
+        std::vector<double> G_Ce(block), G_Co(block), G_Se(block), G_So(block);
+        for (int i0 = 0; i0 < n_north; i0 += block) {
+            const int n = std::min(block, n_north - i0);
+            PlmColumn plm(l_max, std::vector<double>(theta.begin() + i0,
+                                                     theta.begin() + i0 + n));
+            for (int m = 0; m <= l_max; m++) {
+                if (m > 0)
+                    plm.next();
+                for (int k = 0; k < n; k++) {
+                    const int i = i0 + k;
+                    const double w = weights[i] / (2 * n_lon);
+                    const complex F_N = spectra[static_cast<size_t>(i) * h + m];
+                    const complex F_S =
+                        mirror[i] >= 0
+                            ? spectra[static_cast<size_t>(mirror[i]) * h + m]
+                            : 0.0;
+                    G_Ce[k] = w * (F_N.real() + F_S.real());
+                    G_Co[k] = w * (F_N.real() - F_S.real());
+                    G_Se[k] = -w * (F_N.imag() + F_S.imag());
+                    G_So[k] = -w * (F_N.imag() - F_S.imag());
+                }
+                // Quadrature in co-latitude
+                for (int l = m; l <= l_max; l++) {
+                    const bool even = (l - m) % 2 == 0;
+                    const double *G_C = even ? G_Ce.data() : G_Co.data();
+                    const double *G_S = even ? G_Se.data() : G_So.data();
+                    const double *P = plm.get_Plm_bar(l);
+                    double C = 0, S = 0;
+                    for (int k = 0; k < n; k++) {
+                        C += G_C[k] * P[k];
+                        S += G_S[k] * P[k];
+                    }
+                    clm.set_C(l, m, clm.get_C(l, m) + C);
+                    clm.set_S(l, m, clm.get_S(l, m) + S);
+                }
+            }
+        }
+        return clm;
+    };
+
+    /**
+     * @brief Getter for maximum degree
+     */
+    int get_l_max() const { return l_max; };
+
+    /**
+     * @brief Getter for grid type
+     */
+    Type get_type() const { return type; };
+
+    /**
+     * @brief Getter for number of rings
+     */
+    int get_n_lat() const { return n_lat; };
+
+    /**
+     * @brief Getter for number of longitudes per ring
+     */
+    int get_n_lon() const { return n_lon; };
+
+    /**
+     * @brief Getter for ring co-latitude
+     * @param i ring index
+     */
+    double get_theta(int i) const { return theta[i]; };
+
+    /**
+     * @brief Getter for longitude
+     * @param j longitude index
+     */
+    double get_lambda(int j) const { return 2 * M_PI * j / n_lon; };
+
+    /**
+     * @brief Getter for ring quadrature weight
+     * @param i ring index
+     */
+    double get_weight(int i) const { return weights[i]; };
+};
+
+#endif // _GRID_HPP_
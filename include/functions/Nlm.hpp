@@ -10,7 +10,11 @@
 #ifndef _NLM_HPP_
 #define _NLM_HPP_
 
-#include <cmath>
+#include "Scalar.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
 
 /**
  * @file Nlm.hpp
@@ -18,7 +22,7 @@
  */
 
 /**
- * @class Nlm
+ * @class BasicNlm
  *
  * @brief Computes recursively and stores normalization constants for
  * fully-normalized spherical harmonics
@@ -37,10 +41,17 @@
  * \f]
  * This class leverages recursive relations to compute all the normalization
  * constants up to a maximum input degree minimizing the overflow problem.
+ *
+ * Since the constants do not depend on anything but degree and order, the
+ * static get() method provides a single, grow-only table shared among all
+ * users (e.g. every Plm instance) in a thread-safe manner.
+ *
+ * The constants are computed in the precision of the scalar type T (see
+ * Scalar.hpp). Nlm is the double precision version.
  */
-class Nlm {
-    double *_Nlm = nullptr; // Private attribute storing Nlm coefficients
-    int l_max;
+template <typename T> class BasicNlm {
+    T *_Nlm = nullptr; // Private attribute storing Nlm coefficients
+    int l_max = -1;
 
     /**
      * Function that computes global index for internal data structure.
@@ -48,47 +59,54 @@ class Nlm {
      * @param m Order
      * @return Global index
      */
-    int lm_idx(int l, int m) { return (l * (l + 1)) / 2 + m; };
+    size_t lm_idx(int l, int m) const {
+        return (static_cast<size_t>(l) * (l + 1)) / 2 + m;
+    };
 
   public:
     /**
      * Default constructor
      */
-    Nlm() {};
+    BasicNlm() {};
     /**
      * Class constructor
      * @param l_max Maximum degree and order to which the normalization
      * constants are computed
      */
-    Nlm(int l_max) : l_max(l_max) {
-        this->_Nlm = new double[((l_max + 1) * (l_max + 2)) / 2];
+    BasicNlm(int l_max) : l_max(l_max) {
+        this->_Nlm = new T[lm_idx(l_max + 1, 0)];
         for (int l = 0; l <= l_max; l++) {
             // Compute for m = 0
-            _Nlm[lm_idx(l, 0)] = sqrt(2 * l + 1);
+            _Nlm[lm_idx(l, 0)] = Scalar<T>::sqrt(2 * l + 1);
         }
         for (int m = 1; m <= l_max; m++) {
             for (int l = m; l <= l_max; l++) {
                 // Recursion for m > 0
-                _Nlm[lm_idx(l, m)] = _Nlm[lm_idx(l, m - 1)] *
-                                     sqrt(1.0 / ((l - m + 1) * (l + m)));
+                _Nlm[lm_idx(l, m)] =
+                    _Nlm[lm_idx(l, m - 1)] *
+                    Scalar<T>::sqrt(T(1) / ((l - m + 1) * T(l + m)));
             }
         }
         // Adjust k for m>0
         for (int m = 1; m <= l_max; m++) {
             for (int l = m; l <= l_max; l++) {
-                _Nlm[lm_idx(l, m)] *= sqrt(2);
+                _Nlm[lm_idx(l, m)] *= Scalar<T>::sqrt(2);
             }
         }
     };
 
     // Copy assignment operator constructor
-    Nlm &operator=(const Nlm &other) {
+    BasicNlm &operator=(const BasicNlm &other) {
         if (this != &other) {
+            // Release previous data
+            if (_Nlm)
+                delete[] _Nlm;
+            _Nlm = nullptr;
             l_max = other.l_max;
             // Allocate and assign Nlm
             if (other._Nlm) {
-                int Nlm_size = (l_max + 1) * (l_max + 2) / 2;
-                _Nlm = new double[Nlm_size];
+                size_t Nlm_size = lm_idx(l_max + 1, 0);
+                _Nlm = new T[Nlm_size];
                 std::copy(other._Nlm, other._Nlm + Nlm_size, _Nlm);
             }
         }
@@ -96,25 +114,52 @@ class Nlm {
     };
 
     // Copy constructor
-    Nlm(const Nlm &other) : l_max(other.l_max) {
+    BasicNlm(const BasicNlm &other) : l_max(other.l_max) {
         // Allocate and assign Nlm
-        int Nlm_size = (l_max + 1) * (l_max + 2) / 2;
-        _Nlm = new double[Nlm_size];
-        std::copy(other._Nlm, other._Nlm + Nlm_size, _Nlm);
+        if (other._Nlm) {
+            size_t Nlm_size = lm_idx(l_max + 1, 0);
+            _Nlm = new T[Nlm_size];
+            std::copy(other._Nlm, other._Nlm + Nlm_size, _Nlm);
+        }
     };
 
     // Destructor
-    ~Nlm() {
+    ~BasicNlm() {
         if (_Nlm)
             delete[] _Nlm;
     };
 
+    /**
+     * @brief Retrieves a shared table valid at least up to a given degree
+     *
+     * The table is computed on first use and only recomputed when a higher
+     * degree is requested. Tables previously handed out remain valid.
+     * @param l_max Minimum degree required
+     * @return Shared pointer to the normalization constants
+     */
+    static std::shared_ptr<const BasicNlm> get(int l_max) {
+        static std::mutex mutex;
+        static std::shared_ptr<const BasicNlm> table;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!table || table->l_max < l_max) {
+            table = std::make_shared<const BasicNlm>(l_max);
+        }
+        return table;
+    };
+
+    /**
+     * @brief Getter for maximum degree of the table
+     */
+    int get_l_max() const { return l_max; };
+
     /**
      * @brief Getter for normalization constant
      * @param l degree
      * @param m order
      */
-    double get_Nlm(int l, int m) { return _Nlm[lm_idx(l, m)]; };
+    T get_Nlm(int l, int m) const { return _Nlm[lm_idx(l, m)]; };
 };
 
+typedef BasicNlm<double> Nlm;
+
 #endif //_NLM_HPP_
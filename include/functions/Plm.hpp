@@ -10,11 +10,17 @@
 #define _PLM_HPP_
 
 #include "Nlm.hpp"
+#include "PlmCoefficients.hpp"
+#include "ThreadPool.hpp"
+#include "XNumber.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <vector>
 
 /**
- * @class Plm
+ * @class BasicPlm
  *
  * @brief Class that computes and stores the Associated Legendre Functions
  * (ALFs) and its derivatives at a given co-latitude.
@@ -55,16 +61,43 @@
  * \bar{P}_{l-1,m}(\theta))
  * \f]
  *
+ * Beyond degree ~1900, sectorial values underflow the range of doubles close
+ * to the poles (much earlier for floats), which would zero out every value of
+ * the column below. When this may happen, the recursion is carried out with
+ * X-numbers (Fukushima, 2012), see XNumber.hpp. Otherwise, the plain double
+ * recursion is used.
  *
+ * The ALFs are symmetric or antisymmetric about the equator:
+ * \f[
+ * \bar{P}_{lm}(\pi-\theta) = (-1)^{l+m} \bar{P}_{lm}(\theta)
+ * \f]
+ * so a single recursion also provides the ALFs (and its derivatives) at the
+ * mirrored co-latitude \f$ \pi-\theta \f$ through the `_mirror` getters.
+ *
+ * The coefficients \f$ a_{lm}, b_{lm}, f_{lm} \f$ do not depend on the
+ * co-latitude, so they are retrieved from a table shared among all instances
+ * (see PlmCoefficients.hpp) instead of being recomputed by each constructor.
+ *
+ * All the computations are carried out in the precision of the scalar type T
+ * (see Scalar.hpp), e.g. float for fast low-degree evaluations or long double
+ * and `__float128` to validate double precision results. Plm is the double
+ * precision version.
  */
-class Plm {
-    int l_max;    // Maximum degree of ALFs
-    Nlm _Nlm;     // Normalization constants
-    double theta; // Co-latitude
-
-    double *_Plm = nullptr;  // Fully-normalized ALFs
-    double *_dPlm = nullptr; // Fully-normalized ALFs co-latitude derivatives
-    double *_ddPlm =
+template <typename T> class BasicPlm {
+    int l_max; // Maximum degree of ALFs
+    // Normalization constants (lazy)
+    std::shared_ptr<const BasicNlm<T>> _Nlm;
+    // Recursion coefficients
+    std::shared_ptr<const BasicPlmCoefficients<T>> coeffs;
+    T theta; // Co-latitude
+    // Sectorial ALFs with extended range
+    std::vector<BasicXNumber<T>> seeds;
+    // Sectorial values above this threshold never require extended range
+    static constexpr T tiny = Scalar<T>::pow2(30 - BasicXNumber<T>::exponent);
+
+    T *_Plm = nullptr;  // Fully-normalized ALFs
+    T *_dPlm = nullptr; // Fully-normalized ALFs co-latitude derivatives
+    T *_ddPlm =
         nullptr; // Fully-normalized ALFs co-latitude 2nd order derivatives
 
     /**
@@ -73,13 +106,172 @@ class Plm {
      * @param m order
      * @return Global index
      */
-    int lm_idx(int l, int m) { return (l * (l + 1)) / 2 + m; };
+    size_t lm_idx(int l, int m) {
+        return (static_cast<size_t>(l) * (l + 1)) / 2 + m;
+    };
+
+    /**
+     * Function that computes the equatorial parity of an ALF.
+     * @param l degree
+     * @param m order
+     * @return \f$ (-1)^{l+m} \f$
+     */
+    static T parity(int l, int m) { return (l + m) % 2 == 0 ? 1 : -1; };
+
+    /**
+     * Function that applies the sectorial recursion. If extended range is
+     * required, the sectorial values are also kept as X-numbers (Fukushima,
+     * 2012) to seed the column recursions.
+     * @param u Sine of co-latitude
+     * @param extended Flag to indicate whether X-numbers are required or not
+     */
+    void sectorial(T u, bool extended) {
+        _Plm[0] = 1;
+        if (!extended) {
+            for (int l = 1; l <= l_max; l++) {
+                _Plm[lm_idx(l, l)] =
+                    coeffs->get_s(l) * u * _Plm[lm_idx(l - 1, l - 1)];
+            }
+            return;
+        }
+        seeds[0] = BasicXNumber<T>(1);
+        for (int m = 1; m <= l_max; m++) {
+            seeds[m] = seeds[m - 1] * (coeffs->get_s(m) * u);
+            _Plm[lm_idx(m, m)] = seeds[m].to_double();
+        }
+    };
+
+    /**
+     * Function that applies the FOID column recursions for a range of orders.
+     * With extended range, each column is computed with X-numbers until it
+     * reaches the range of doubles, so that values below the range are not
+     * flushed to zero before the recursion brings them back into range.
+     * @param m_begin First order
+     * @param m_end Last order (not included)
+     * @param t Cosine of co-latitude
+     * @param extended Flag to indicate whether X-numbers are required or not
+     */
+    void columns(int m_begin, int m_end, T t, bool extended) {
+        for (int m = m_begin; m < std::min(m_end, l_max); m++) { // Fix order
+            int l = m + 2;
+            if (!extended) {
+                // Terms right below the diagonal
+                _Plm[lm_idx(m + 1, m)] =
+                    coeffs->get_a(m + 1, m) * t * _Plm[lm_idx(m, m)];
+            } else {
+                // Terms right below the diagonal
+                BasicXNumber<T> P_2 = seeds[m];
+                BasicXNumber<T> P_1 = P_2 * (coeffs->get_a(m + 1, m) * t);
+                _Plm[lm_idx(m + 1, m)] = P_1.to_double();
+                // Other terms with X-numbers while out of range
+                for (; l <= l_max && (P_1.get_i() != 0 || P_2.get_i() != 0);
+                     l++) {
+                    BasicXNumber<T> P = BasicXNumber<T>::lsum2(
+                        coeffs->get_a(l, m) * t, P_1, -coeffs->get_b(l, m),
+                        P_2);
+                    _Plm[lm_idx(l, m)] = P.to_double();
+                    P_2 = P_1;
+                    P_1 = P;
+                }
+            }
+            // Other terms with doubles
+            for (; l <= l_max; l++) {
+                _Plm[lm_idx(l, m)] =
+                    coeffs->get_a(l, m) * t * _Plm[lm_idx(l - 1, m)] -
+                    coeffs->get_b(l, m) * _Plm[lm_idx(l - 2, m)];
+            }
+        }
+    };
+
+    /**
+     * Function that computes the derivatives for a range of degrees.
+     * @param l_begin First degree
+     * @param l_end Last degree (not included)
+     * @param t Cosine of co-latitude
+     * @param u Sine of co-latitude
+     */
+    void derivative_rows(int l_begin, int l_end, T t, T u) {
+        for (int l = l_begin; l < l_end; l++) {
+            // Terms below diagonal
+            for (int m = 0; m < l; m++) {
+                _dPlm[lm_idx(l, m)] =
+                    T(1) / u *
+                    (l * t * _Plm[lm_idx(l, m)] -
+                     coeffs->get_f(l, m) * _Plm[lm_idx(l - 1, m)]);
+            }
+            // Sectorial term
+            _dPlm[lm_idx(l, l)] = l * t / u * _Plm[lm_idx(l, l)];
+        }
+    };
+
+    /**
+     * Function that computes the 2nd order derivatives for a range of
+     * degrees.
+     * @param l_begin First degree
+     * @param l_end Last degree (not included)
+     * @param t Cosine of co-latitude
+     * @param u Sine of co-latitude
+     */
+    void second_derivative_rows(int l_begin, int l_end, T t, T u) {
+        for (int l = l_begin; l < l_end; l++) {
+            // Terms below diagonal
+            for (int m = 0; m < l; m++) {
+                _ddPlm[lm_idx(l, m)] =
+                    T(1) / u *
+                        ((l - 1) * t * _dPlm[lm_idx(l, m)] -
+                         coeffs->get_f(l, m) * _dPlm[lm_idx(l - 1, m)]) -
+                    l * _Plm[lm_idx(l, m)];
+            }
+            // Sectorial term
+            _ddPlm[lm_idx(l, l)] = (l - 1) * t / u * _dPlm[lm_idx(l, l)] -
+                                   l * _Plm[lm_idx(l, l)];
+        }
+    };
+
+    /**
+     * Function that splits the orders in ranges of similar work, given that
+     * the column of order m has \f$ l_{max}-m+1 \f$ terms. Ranges are
+     * sorted by decreasing column length.
+     * @param i Range index
+     * @param n Number of ranges
+     * @return First order of the range
+     */
+    int split_orders(int i, int n) const {
+        const double N = l_max + 1;
+        const double remaining = static_cast<double>(n - i) / n;
+        const int m = N - std::floor(std::sqrt(remaining * N * (N + 1)));
+        return i == n ? l_max + 1 : std::max(0, std::min(m, l_max + 1));
+    };
+
+    /**
+     * Function that splits the degrees in ranges of similar work, given that
+     * the row of degree l has \f$ l+1 \f$ terms.
+     * @param i Range index
+     * @param n Number of ranges
+     * @return First degree of the range
+     */
+    int split_degrees(int i, int n) const {
+        const double N = l_max + 1;
+        const int l = std::round(N * std::sqrt(static_cast<double>(i) / n));
+        return i == n ? l_max + 1 : std::max(0, std::min(l, l_max + 1));
+    };
+
+    /**
+     * Function that retrieves the shared normalization constants, which are
+     * only looked up the first time an unnormalized value is requested.
+     * @return Normalization constants
+     */
+    const BasicNlm<T> &get_Nlm() {
+        if (!_Nlm)
+            _Nlm = BasicNlm<T>::get(l_max);
+        return *_Nlm;
+    };
 
   public:
     /**
      * Default constructor
      */
-    Plm() {};
+    BasicPlm() {};
     /**
      * Class constructor
      * @param l_max Maximum degree to which the ALFs (or its derivatives) are
@@ -92,128 +284,97 @@ class Plm {
      * not
      * @param second_derivatives Flag to indicate whether 2nd order derivatives
      * are computed or not
+     * @param pool Thread pool (optional) for ultra-high degrees, see evaluate
      */
-    Plm(int l_max, double theta, bool derivatives = false,
-        bool second_derivatives = false)
-        : l_max(l_max), _Nlm(Nlm(l_max)), theta(theta) {
+    BasicPlm(int l_max, T theta, bool derivatives = false,
+             bool second_derivatives = false, ThreadPool *pool = nullptr)
+        : l_max(l_max), coeffs(BasicPlmCoefficients<T>::get(l_max)),
+          seeds(l_max + 1) {
         // Allocate ALFs
-        this->_Plm = new double[((l_max + 1) * (l_max + 2)) / 2];
-        // Define constants for FOID recursion
-        double *a = new double[((l_max + 1) * (l_max + 2)) / 2];
-        double *b = new double[((l_max + 1) * (l_max + 2)) / 2];
-        for (int l = 0; l <= l_max; l++) {
-            for (int m = 0; m < l; m++) {
-                a[lm_idx(l, m)] =
-                    sqrt((2 * l - 1.0) * (2 * l + 1) / ((l - m) * (l + m)));
-                b[lm_idx(l, m)] =
-                    l - m != 1
-                        ? sqrt(((2 * l + 1.0) * (l + m - 1) * (l - m - 1)) /
-                               ((l - m) * (l + m) * (2 * l - 3)))
-                        : 0;
-            }
-        }
-        // Define cosine, sine
-        double t = cos(theta);
-        double u = sin(theta);
-        // Define P00
-        _Plm[0] = 1;
-        // Define P11
-        if (l_max > 0)
-            _Plm[lm_idx(1, 1)] = sqrt(3) * u;
-        // Recursion for sectorial polynomials
-        for (int l = 2; l <= l_max; l++) {
-            _Plm[lm_idx(l, l)] =
-                sqrt((2 * l + 1.0) / (2 * l)) * u * _Plm[lm_idx(l - 1, l - 1)];
-        }
-        // Recursion for terms below diagonal
-        for (int m = 0; m < l_max; m++) { // Fix order
-            // Now increase degree
-            int l = m + 1;
-            // Terms right below the diagonal
-            _Plm[lm_idx(l, m)] = a[lm_idx(l, m)] * t * _Plm[lm_idx(l - 1, m)];
-            // Other terms
-            for (int l = m + 2; l <= l_max; l++) {
-                _Plm[lm_idx(l, m)] =
-                    a[lm_idx(l, m)] * t * _Plm[lm_idx(l - 1, m)] -
-                    b[lm_idx(l, m)] * _Plm[lm_idx(l - 2, m)];
-            }
-        }
-        // Delete allocated data
-        delete[] a;
-        delete[] b;
-        // Compute derivatives
+        const size_t Plm_size = lm_idx(l_max + 1, 0);
+        _Plm = new T[Plm_size];
         if (derivatives) {
             // Allocate derivatives
-            _dPlm = new double[((l_max + 1) * (l_max + 2)) / 2];
-            // Constant for derivatives recursion
-            double *f = new double[((l_max + 1) * (l_max + 2)) / 2];
-            for (int l = 0; l <= l_max; l++) {
-                for (int m = 0; m <= l; m++) {
-                    f[lm_idx(l, m)] =
-                        sqrt((l * l - m * m) * (2 * l + 1) / (2 * l - 1.0));
-                }
-            }
-            // Sectorial terms
-            for (int m = 0; m <= l_max; m++) {
-                _dPlm[lm_idx(m, m)] = m * t / u * _Plm[lm_idx(m, m)];
-            }
-            // Terms below diagonal
-            for (int l = 1; l <= l_max; l++) {
-                for (int m = 0; m < l; m++) {
-                    _dPlm[lm_idx(l, m)] =
-                        1.0 / u *
-                        (l * t * _Plm[lm_idx(l, m)] -
-                         f[lm_idx(l, m)] * _Plm[lm_idx(l - 1, m)]);
-                }
-            }
-
-            // Compute 2nd order derivatives
+            _dPlm = new T[Plm_size];
             if (second_derivatives) {
                 // Allocate 2nd order derivatives
-                _ddPlm = new double[((l_max + 1) * (l_max + 2)) / 2];
-                // Sectorial terms
-                for (int m = 0; m <= l_max; m++) {
-                    _ddPlm[lm_idx(m, m)] =
-                        (m - 1) * t / u * _dPlm[lm_idx(m, m)] -
-                        m * _Plm[lm_idx(m, m)];
-                }
-                // Terms below diagonal
-                for (int l = 1; l <= l_max; l++) {
-                    for (int m = 0; m < l; m++) {
-                        _ddPlm[lm_idx(l, m)] =
-                            1.0 / u *
-                                ((l - 1) * t * _dPlm[lm_idx(l, m)] -
-                                 f[lm_idx(l, m)] * _dPlm[lm_idx(l - 1, m)]) -
-                            l * _Plm[lm_idx(l, m)];
-                    }
-                }
-            } else {
-                _ddPlm = nullptr;
+                _ddPlm = new T[Plm_size];
             }
-            // Delete allocated data
-            delete[] f;
-        } else {
-            _dPlm = nullptr;
         }
+        evaluate(theta, pool);
+    };
+
+    /**
+     * @brief Re-evaluates the ALFs (and its derivatives) in place at a new
+     * co-latitude
+     *
+     * The maximum degree and derivative flags of the constructor are kept and
+     * the storage is reused, so this method never allocates memory. This is
+     * meant for repeated evaluations, e.g. at every step of an orbit
+     * propagation.
+     *
+     * Once the sectorial terms are known, the columns of different orders
+     * (and the rows of derivatives of different degrees) are independent. If
+     * a thread pool is given, they are split among its threads in ranges of
+     * similar work. Every value is computed by the same code as in the serial
+     * path, so the results are bit-identical.
+     * @param theta Co-latitude at which the ALFs (and its derivatives) are
+     * evaluated
+     * @param pool Thread pool (optional) for ultra-high degrees
+     */
+    void evaluate(T theta, ThreadPool *pool = nullptr) {
+        this->theta = theta;
+        // Define cosine, sine
+        T t = Scalar<T>::cos(theta);
+        T u = Scalar<T>::sin(theta);
+        // Extended range is required if sectorial values may underflow
+        const bool extended =
+            !(u == 0 || l_max * Scalar<T>::log(u) > Scalar<T>::log(tiny));
+        sectorial(u, extended);
+        if (!pool || pool->get_n_threads() == 1) {
+            columns(0, l_max, t, extended);
+            if (_dPlm)
+                derivative_rows(0, l_max + 1, t, u);
+            if (_ddPlm)
+                second_derivative_rows(0, l_max + 1, t, u);
+            return;
+        }
+        // A few ranges per thread for dynamic load balancing
+        const int n = 4 * pool->get_n_threads();
+        pool->run(n, [&](int i) {
+            columns(split_orders(i, n), split_orders(i + 1, n), t, extended);
+        });
+        // Longest rows first
+        if (_dPlm)
+            pool->run(n, [&](int i) {
+                derivative_rows(split_degrees(n - 1 - i, n),
+                                split_degrees(n - i, n), t, u);
+            });
+        if (_ddPlm)
+            pool->run(n, [&](int i) {
+                second_derivative_rows(split_degrees(n - 1 - i, n),
+                                       split_degrees(n - i, n), t, u);
+            });
     };
 
     // Copy constructor
-    Plm(const Plm &other)
-        : l_max(other.l_max), _Nlm(other._Nlm), theta(other.theta) {
+    BasicPlm(const BasicPlm &other)
+        : l_max(other.l_max), _Nlm(other._Nlm), coeffs(other.coeffs),
+          theta(other.theta), seeds(other.seeds) {
         // Allocate and assign Plm
-        int Plm_size = (l_max + 1) * (l_max + 2) / 2;
-        _Plm = new double[Plm_size];
+        size_t Plm_size = lm_idx(l_max + 1, 0);
+        _Plm = new T[Plm_size];
         std::copy(other._Plm, other._Plm + Plm_size, _Plm);
         // Allocate and assign derivatives
         if (other._dPlm) {
-            _dPlm = new double[Plm_size];
+            _dPlm = new T[Plm_size];
             std::copy(other._dPlm, other._dPlm + Plm_size, _dPlm);
         } else {
             _dPlm = nullptr;
         }
         // Allocate and assign 2nd order derivatives
         if (other._ddPlm) {
-            _ddPlm = new double[Plm_size];
+            _ddPlm = new T[Plm_size];
             std::copy(other._ddPlm, other._ddPlm + Plm_size, _ddPlm);
         } else {
             _ddPlm = nullptr;
@@ -221,7 +382,7 @@ class Plm {
     };
 
     // Copy assignment operator
-    Plm &operator=(const Plm &other) {
+    BasicPlm &operator=(const BasicPlm &other) {
         if (this != &other) {
             if (_Plm)
                 delete[] _Plm;
@@ -232,26 +393,28 @@ class Plm {
             // Copy data
             theta = other.theta;
             _Nlm = other._Nlm;
+            coeffs = other.coeffs;
             l_max = other.l_max;
+            seeds = other.seeds;
             // Compute total size
-            int Plm_size = (l_max + 1) * (l_max + 2) / 2;
+            size_t Plm_size = lm_idx(l_max + 1, 0);
             // Allocate and assign Plm
             if (other._Plm) {
-                _Plm = new double[Plm_size];
+                _Plm = new T[Plm_size];
                 std::copy(other._Plm, other._Plm + Plm_size, _Plm);
             } else {
                 _Plm = nullptr;
             }
             // Allocate and assign derivatives
             if (other._dPlm) {
-                _dPlm = new double[Plm_size];
+                _dPlm = new T[Plm_size];
                 std::copy(other._dPlm, other._dPlm + Plm_size, _dPlm);
             } else {
                 _dPlm = nullptr;
             }
             // Allocate and assign 2nd order derivatives
             if (other._ddPlm) {
-                _ddPlm = new double[Plm_size];
+                _ddPlm = new T[Plm_size];
                 std::copy(other._ddPlm, other._ddPlm + Plm_size, _ddPlm);
             } else {
                 _ddPlm = nullptr;
@@ -261,7 +424,7 @@ class Plm {
     };
 
     // Destructor
-    ~Plm() {
+    ~BasicPlm() {
         if (_Plm)
             delete[] _Plm;
         if (_dPlm)
@@ -275,15 +438,15 @@ class Plm {
      * @param l degree
      * @param m order
      */
-    double get_Plm_bar(int l, int m) { return _Plm[lm_idx(l, m)]; };
+    T get_Plm_bar(int l, int m) { return _Plm[lm_idx(l, m)]; };
 
     /**
      * @brief Getter for unnormalized ALF
      * @param l degree
      * @param m order
      */
-    double get_Plm(int l, int m) {
-        return _Plm[lm_idx(l, m)] / _Nlm.get_Nlm(l, m);
+    T get_Plm(int l, int m) {
+        return _Plm[lm_idx(l, m)] / get_Nlm().get_Nlm(l, m);
     };
 
     /**
@@ -291,15 +454,15 @@ class Plm {
      * @param l degree
      * @param m order
      */
-    double get_dPlm_bar(int l, int m) { return _dPlm[lm_idx(l, m)]; };
+    T get_dPlm_bar(int l, int m) { return _dPlm[lm_idx(l, m)]; };
 
     /**
      * @brief Getter for unnormalized ALF derivative
      * @param l degree
      * @param m order
      */
-    double get_dPlm(int l, int m) {
-        return _dPlm[lm_idx(l, m)] / _Nlm.get_Nlm(l, m);
+    T get_dPlm(int l, int m) {
+        return _dPlm[lm_idx(l, m)] / get_Nlm().get_Nlm(l, m);
     };
 
     /**
@@ -307,21 +470,83 @@ class Plm {
      * @param l degree
      * @param m order
      */
-    double get_ddPlm_bar(int l, int m) { return _ddPlm[lm_idx(l, m)]; };
+    T get_ddPlm_bar(int l, int m) { return _ddPlm[lm_idx(l, m)]; };
 
     /**
      * @brief Getter for unnormalized ALF derivative
      * @param l degree
      * @param m order
      */
-    double get_ddPlm(int l, int m) {
-        return _ddPlm[lm_idx(l, m)] / _Nlm.get_Nlm(l, m);
+    T get_ddPlm(int l, int m) {
+        return _ddPlm[lm_idx(l, m)] / get_Nlm().get_Nlm(l, m);
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF at the mirrored co-latitude
+     * \f$ \pi-\theta \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_Plm_bar_mirror(int l, int m) {
+        return parity(l, m) * _Plm[lm_idx(l, m)];
+    };
+
+    /**
+     * @brief Getter for unnormalized ALF at the mirrored co-latitude
+     * \f$ \pi-\theta \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_Plm_mirror(int l, int m) {
+        return parity(l, m) * get_Plm(l, m);
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF derivative at the mirrored
+     * co-latitude \f$ \pi-\theta \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_dPlm_bar_mirror(int l, int m) {
+        return -parity(l, m) * _dPlm[lm_idx(l, m)];
+    };
+
+    /**
+     * @brief Getter for unnormalized ALF derivative at the mirrored
+     * co-latitude \f$ \pi-\theta \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_dPlm_mirror(int l, int m) {
+        return -parity(l, m) * get_dPlm(l, m);
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF 2nd order derivative at the
+     * mirrored co-latitude \f$ \pi-\theta \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_ddPlm_bar_mirror(int l, int m) {
+        return parity(l, m) * _ddPlm[lm_idx(l, m)];
+    };
+
+    /**
+     * @brief Getter for unnormalized ALF 2nd order derivative at the mirrored
+     * co-latitude \f$ \pi-\theta \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_ddPlm_mirror(int l, int m) {
+        return parity(l, m) * get_ddPlm(l, m);
     };
 
     /**
      * @brief Getter for associated colatitude
      */
-    double get_theta() const { return theta; };
+    T get_theta() const { return theta; };
 };
 
+typedef BasicPlm<double> Plm;
+
 #endif // _PLM_HPP_
@@ -0,0 +1,521 @@
+/**
+ * @file PlmBatch.hpp
+ *
+ * @brief Header file to define batched Associated Legendre Functions (ALFs)
+ * class
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _PLM_BATCH_HPP_
+#define _PLM_BATCH_HPP_
+
+#include "PlmCoefficients.hpp"
+#include "XNumber.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+/**
+ * @class PlmBatch
+ *
+ * @brief Class that computes and stores the Associated Legendre Functions
+ * (ALFs) and its derivatives at a block of co-latitudes.
+ *
+ * This class applies the same FOID recursion as Plm (Holmes and Featherstone,
+ * 2002) but evaluates a whole block of co-latitudes at once. The data is
+ * stored in a structure-of-arrays layout: for every \f$(l,m)\f$ pair, the
+ * values at all the co-latitudes are contiguous in memory. As a result, every
+ * step of the sectorial and column recursions is a loop over co-latitudes with
+ * no dependencies among iterations, which the compiler vectorizes (e.g. with
+ * AVX2/AVX-512 under `-march=native`).
+ *
+ * Each row is padded up to a multiple of `lanes` co-latitudes so that the
+ * vectorized loops have no remainder. Padding lanes are evaluated at the
+ * equator and are never exposed through the getters.
+ */
+class PlmBatch {
+    int l_max;                 // Maximum degree of ALFs
+    int n;                     // Number of co-latitudes
+    int stride;                // Padded number of co-latitudes per row
+    std::vector<double> theta; // Co-latitudes
+
+    std::vector<double> _Plm;   // Fully-normalized ALFs
+    std::vector<double> _dPlm;  // Fully-normalized ALFs derivatives
+    std::vector<double> _ddPlm; // Fully-normalized ALFs 2nd order derivatives
+
+    /**
+     * Function that computes global index for a given degree and order.
+     * @param l degree
+     * @param m order
+     * @return Global index
+     */
+    size_t lm_idx(int l, int m) const {
+        return (static_cast<size_t>(l) * (l + 1)) / 2 + m;
+    };
+
+    /**
+     * Function that computes the offset of the first co-latitude of a row.
+     * @param l degree
+     * @param m order
+     * @return Row offset
+     */
+    size_t row(int l, int m) const {
+        return lm_idx(l, m) * stride;
+    };
+
+  public:
+    /**
+     * Number of co-latitudes each row is padded to.
+     */
+    static constexpr int lanes = 8;
+
+    /**
+     * Default constructor
+     */
+    PlmBatch() : l_max(0), n(0), stride(0) {};
+
+    /**
+     * Class constructor
+     * @param l_max Maximum degree to which the ALFs (or its derivatives) are
+     * computed
+     * @param theta Co-latitudes at which the ALFs (and its derivatives) are
+     * evaluated
+     * @param derivatives Flag to indicate whether derivatives are computed or
+     * not
+     * @param second_derivatives Flag to indicate whether 2nd order derivatives
+     * are computed or not
+     */
+    PlmBatch(int l_max, const std::vector<double> &theta,
+             bool derivatives = false, bool second_derivatives = false)
+        : l_max(l_max), n(theta.size()), theta(theta) {
+        stride = ((n + lanes - 1) / lanes) * lanes;
+        const size_t size = lm_idx(l_max + 1, 0);
+        _Plm.resize(size * stride);
+        // Define cosine, sine (padding lanes at the equator)
+        std::vector<double> t(stride, 0.0), u(stride, 1.0);
+        for (int k = 0; k < n; k++) {
+            t[k] = cos(theta[k]);
+            u[k] = sin(theta[k]);
+        }
+        // Retrieve shared constants for FOID recursion
+        std::shared_ptr<const PlmCoefficients> coeffs =
+            PlmCoefficients::get(l_max);
+        double *P = _Plm.data();
+        // Define P00
+        for (int k = 0; k < stride; k++) {
+            P[k] = 1;
+        }
+        // Recursion for sectorial polynomials
+        for (int l = 1; l <= l_max; l++) {
+            const double s = coeffs->get_s(l);
+            double *P_ll = P + row(l, l);
+            const double *P_prev = P + row(l - 1, l - 1);
+            for (int k = 0; k < stride; k++) {
+                P_ll[k] = s * u[k] * P_prev[k];
+            }
+        }
+        // Recursion for terms below diagonal
+        for (int m = 0; m < l_max; m++) { // Fix order
+            // Terms right below the diagonal
+            int l = m + 1;
+            double a = coeffs->get_a(l, m);
+            double *P_lm = P + row(l, m);
+            const double *P_1 = P + row(l - 1, m);
+            for (int k = 0; k < stride; k++) {
+                P_lm[k] = a * t[k] * P_1[k];
+            }
+            // Other terms
+            for (l = m + 2; l <= l_max; l++) {
+                a = coeffs->get_a(l, m);
+                const double b = coeffs->get_b(l, m);
+                P_lm = P + row(l, m);
+                P_1 = P + row(l - 1, m);
+                const double *P_2 = P + row(l - 2, m);
+                for (int k = 0; k < stride; k++) {
+                    P_lm[k] = a * t[k] * P_1[k] - b * P_2[k];
+                }
+            }
+        }
+        if (!derivatives) {
+            return;
+        }
+        // Compute derivatives
+        std::vector<double> tu(stride), inv_u(stride);
+        for (int k = 0; k < stride; k++) {
+            inv_u[k] = 1.0 / u[k];
+            tu[k] = t[k] * inv_u[k];
+        }
+        _dPlm.resize(_Plm.size());
+        double *dP = _dPlm.data();
+        for (int l = 0; l <= l_max; l++) {
+            // Sectorial terms
+            const double *P_ll = P + row(l, l);
+            double *dP_ll = dP + row(l, l);
+            for (int k = 0; k < stride; k++) {
+                dP_ll[k] = l * tu[k] * P_ll[k];
+            }
+            // Terms below diagonal
+            for (int m = 0; m < l; m++) {
+                const double f = coeffs->get_f(l, m);
+                const double *P_lm = P + row(l, m);
+                const double *P_1 = P + row(l - 1, m);
+                double *dP_lm = dP + row(l, m);
+                for (int k = 0; k < stride; k++) {
+                    dP_lm[k] = l * tu[k] * P_lm[k] - f * inv_u[k] * P_1[k];
+                }
+            }
+        }
+        if (!second_derivatives) {
+            return;
+        }
+        // Compute 2nd order derivatives
+        _ddPlm.resize(_Plm.size());
+        double *ddP = _ddPlm.data();
+        for (int l = 0; l <= l_max; l++) {
+            // Sectorial terms
+            const double *P_ll = P + row(l, l);
+            const double *dP_ll = dP + row(l, l);
+            double *ddP_ll = ddP + row(l, l);
+            for (int k = 0; k < stride; k++) {
+                ddP_ll[k] = (l - 1) * tu[k] * dP_ll[k] - l * P_ll[k];
+            }
+            // Terms below diagonal
+            for (int m = 0; m < l; m++) {
+                const double f = coeffs->get_f(l, m);
+                const double *P_lm = P + row(l, m);
+                const double *dP_lm = dP + row(l, m);
+                const double *dP_1 = dP + row(l - 1, m);
+                double *ddP_lm = ddP + row(l, m);
+                for (int k = 0; k < stride; k++) {
+                    ddP_lm[k] = (l - 1) * tu[k] * dP_lm[k] -
+                                f * inv_u[k] * dP_1[k] - l * P_lm[k];
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF
+     * @param l degree
+     * @param m order
+     * @param k co-latitude index
+     */
+    double get_Plm_bar(int l, int m, int k) const {
+        return _Plm[row(l, m) + k];
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF at all co-latitudes
+     * @param l degree
+     * @param m order
+     * @return Pointer to the contiguous values at each co-latitude
+     */
+    const double *get_Plm_bar(int l, int m) const {
+        return _Plm.data() + row(l, m);
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF derivative
+     * @param l degree
+     * @param m order
+     * @param k co-latitude index
+     */
+    double get_dPlm_bar(int l, int m, int k) const {
+        return _dPlm[row(l, m) + k];
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF derivative at all co-latitudes
+     * @param l degree
+     * @param m order
+     * @return Pointer to the contiguous values at each co-latitude
+     */
+    const double *get_dPlm_bar(int l, int m) const {
+        return _dPlm.data() + row(l, m);
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF 2nd order derivative
+     * @param l degree
+     * @param m order
+     * @param k co-latitude index
+     */
+    double get_ddPlm_bar(int l, int m, int k) const {
+        return _ddPlm[row(l, m) + k];
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF 2nd order derivative at all
+     * co-latitudes
+     * @param l degree
+     * @param m order
+     * @return Pointer to the contiguous values at each co-latitude
+     */
+    const double *get_ddPlm_bar(int l, int m) const {
+        return _ddPlm.data() + row(l, m);
+    };
+
+    /**
+     * @brief Getter for number of co-latitudes
+     */
+    int get_n() const { return n; };
+
+    /**
+     * @brief Getter for associated co-latitude
+     * @param k co-latitude index
+     */
+    double get_theta(int k) const { return theta[k]; };
+};
+
+/**
+ * @class BasicPlmColumn
+ *
+ * @brief Class that computes the Associated Legendre Functions (ALFs) and its
+ * derivatives at a block of co-latitudes one order at a time.
+ *
+ * This class runs the same recursions as PlmBatch, but only keeps the
+ * sectorial seeds \f$ \bar{P}_{mm} \f$ and the column \f$ \bar{P}_{lm}, m
+ * \leq l \leq l_{max} \f$ of the current order in memory. Advancing to the next
+ * order reuses the same storage, so the working set is one column per
+ * co-latitude instead of a full triangle. This is the building block for
+ * algorithms that consume the ALFs order by order (e.g. Flmp).
+ *
+ * The layout is the same structure-of-arrays as in PlmBatch, padded to a
+ * multiple of `lanes` co-latitudes (the same vector width as PlmBatch).
+ *
+ * The ALFs are computed in the precision of the scalar type T (see
+ * Scalar.hpp). PlmColumn is the double precision version.
+ *
+ * The sectorial seeds are carried as X-numbers (see XNumber.hpp), so the class
+ * remains valid at ultra-high degrees close to the poles. Co-latitudes whose
+ * seed lies outside the range of doubles are recomputed with the extended
+ * range recursion described in Plm.hpp, while the rest of the block follows
+ * the vectorized recursion.
+ */
+template <typename T> class BasicPlmColumn {
+  public:
+    /**
+     * @brief Number of co-latitudes per vector
+     */
+    static constexpr int lanes =
+        std::max<int>(1, PlmBatch::lanes * sizeof(double) / sizeof(T));
+
+  private:
+    int l_max;  // Maximum degree of ALFs
+    int n;      // Number of co-latitudes
+    int stride; // Padded number of co-latitudes per row
+    int m;      // Current order
+    bool derivatives;
+    // Recursion coefficients
+    std::shared_ptr<const BasicPlmCoefficients<T>> coeffs;
+
+    std::vector<T> t, u;      // Cosine and sine of co-latitudes
+    std::vector<T> tu, inv_u; // Cotangent and cosecant of co-latitudes
+    std::vector<T> _Pmm;      // Sectorial ALFs of current order
+    std::vector<int> _Pmm_i;  // Sectorial ALFs X-number exponents
+    std::vector<int> l_start; // First degree computed with doubles
+    std::vector<T> _Plm;      // Fully-normalized ALFs of current order
+    std::vector<T> _dPlm;     // Fully-normalized ALFs derivatives
+
+    /**
+     * Function that computes the offset of the first co-latitude of a row.
+     * @param l degree
+     * @return Row offset
+     */
+    size_t row(int l) const { return static_cast<size_t>(l - m) * stride; };
+
+    /**
+     * Function that applies the column recursion for the current order at a
+     * single co-latitude using X-numbers while the values are out of range.
+     * @param k co-latitude index
+     * @return First degree to be computed with doubles
+     */
+    int compute_xnumber(int k) {
+        T *P = _Plm.data() + k;
+        BasicXNumber<T> P_2(_Pmm[k], _Pmm_i[k]);
+        P[0] = P_2.to_double();
+        if (m == l_max)
+            return m + 1;
+        // Terms right below the diagonal
+        BasicXNumber<T> P_1 = P_2 * (coeffs->get_a(m + 1, m) * t[k]);
+        P[row(m + 1)] = P_1.to_double();
+        // Other terms with X-numbers while out of range
+        int l = m + 2;
+        for (; l <= l_max && (P_1.get_i() != 0 || P_2.get_i() != 0); l++) {
+            BasicXNumber<T> P_lm = BasicXNumber<T>::lsum2(
+                coeffs->get_a(l, m) * t[k], P_1, -coeffs->get_b(l, m), P_2);
+            P[row(l)] = P_lm.to_double();
+            P_2 = P_1;
+            P_1 = P_lm;
+        }
+        return l;
+    };
+
+    /**
+     * Function that applies the column recursions for the current order.
+     */
+    void compute() {
+        T *P = _Plm.data();
+        bool extended = false;
+        for (int k = 0; k < stride; k++) {
+            P[k] = _Pmm[k];
+            extended |= _Pmm_i[k] != 0;
+        }
+        if (m < l_max) {
+            // Terms right below the diagonal
+            const T a = coeffs->get_a(m + 1, m);
+            T *P_1 = P + row(m + 1);
+            for (int k = 0; k < stride; k++) {
+                P_1[k] = a * t[k] * P[k];
+            }
+        }
+        if (!extended) {
+            // Other terms
+            for (int l = m + 2; l <= l_max; l++) {
+                const T a = coeffs->get_a(l, m);
+                const T b = coeffs->get_b(l, m);
+                T *P_lm = P + row(l);
+                const T *P_1 = P + row(l - 1);
+                const T *P_2 = P + row(l - 2);
+                for (int k = 0; k < stride; k++) {
+                    P_lm[k] = a * t[k] * P_1[k] - b * P_2[k];
+                }
+            }
+        } else {
+            // Co-latitudes with sectorial terms out of range start the
+            // recursion with doubles once the values are back in range
+            for (int k = 0; k < stride; k++) {
+                l_start[k] = _Pmm_i[k] == 0 ? m + 2 : compute_xnumber(k);
+            }
+            for (int l = m + 2; l <= l_max; l++) {
+                const T a = coeffs->get_a(l, m);
+                const T b = coeffs->get_b(l, m);
+                T *P_lm = P + row(l);
+                const T *P_1 = P + row(l - 1);
+                const T *P_2 = P + row(l - 2);
+                for (int k = 0; k < stride; k++) {
+                    P_lm[k] = l >= l_start[k] ? a * t[k] * P_1[k] - b * P_2[k]
+                                              : P_lm[k];
+                }
+            }
+        }
+        if (!derivatives) {
+            return;
+        }
+        T *dP = _dPlm.data();
+        // Sectorial terms
+        for (int k = 0; k < stride; k++) {
+            dP[k] = m * tu[k] * P[k];
+        }
+        // Terms below diagonal
+        for (int l = m + 1; l <= l_max; l++) {
+            const T f = coeffs->get_f(l, m);
+            const T *P_lm = P + row(l);
+            const T *P_1 = P + row(l - 1);
+            T *dP_lm = dP + row(l);
+            for (int k = 0; k < stride; k++) {
+                dP_lm[k] = l * tu[k] * P_lm[k] - f * inv_u[k] * P_1[k];
+            }
+        }
+    };
+
+  public:
+    /**
+     * Class constructor. The ALFs are computed for order zero.
+     * @param l_max Maximum degree to which the ALFs (or its derivatives) are
+     * computed
+     * @param theta Co-latitudes at which the ALFs (and its derivatives) are
+     * evaluated
+     * @param derivatives Flag to indicate whether derivatives are computed or
+     * not
+     */
+    BasicPlmColumn(int l_max, const std::vector<T> &theta,
+                   bool derivatives = false)
+        : l_max(l_max), n(theta.size()), m(0), derivatives(derivatives),
+          coeffs(BasicPlmCoefficients<T>::get(l_max)) {
+        stride = ((n + lanes - 1) / lanes) * lanes;
+        // Define cosine, sine (padding lanes at the equator)
+        t.assign(stride, 0.0);
+        u.assign(stride, 1.0);
+        for (int k = 0; k < n; k++) {
+            t[k] = Scalar<T>::cos(theta[k]);
+            u[k] = Scalar<T>::sin(theta[k]);
+        }
+        // Define P00
+        _Pmm.assign(stride, 1.0);
+        _Pmm_i.assign(stride, 0);
+        l_start.resize(stride);
+        _Plm.resize(static_cast<size_t>(l_max + 1) * stride);
+        if (derivatives) {
+            tu.resize(stride);
+            inv_u.resize(stride);
+            for (int k = 0; k < stride; k++) {
+                inv_u[k] = T(1) / u[k];
+                tu[k] = t[k] * inv_u[k];
+            }
+            _dPlm.resize(_Plm.size());
+        }
+        compute();
+    };
+
+    /**
+     * @brief Advances to the next order, overwriting the current column
+     */
+    void next() { seek(m + 1); };
+
+    /**
+     * @brief Advances to a later order, overwriting the current column. Only
+     * the sectorial seeds of the orders in between are computed, with the
+     * same operations as successive calls to next()
+     * @param m_next Order, not below the current one
+     */
+    void seek(int m_next) {
+        if (m_next == m)
+            return;
+        for (; m < m_next; m++) {
+            const T s = coeffs->get_s(m + 1);
+            for (int k = 0; k < stride; k++) {
+                const BasicXNumber<T> P_mm =
+                    BasicXNumber<T>(_Pmm[k], _Pmm_i[k]) * (s * u[k]);
+                _Pmm[k] = P_mm.get_x();
+                _Pmm_i[k] = P_mm.get_i();
+            }
+        }
+        compute();
+    };
+
+    /**
+     * @brief Getter for current order
+     */
+    int get_m() const { return m; };
+
+    /**
+     * @brief Getter for fully-normalized ALF of the current order at all
+     * co-latitudes
+     * @param l degree
+     * @return Pointer to the contiguous values at each co-latitude
+     */
+    const T *get_Plm_bar(int l) const { return _Plm.data() + row(l); };
+
+    /**
+     * @brief Getter for fully-normalized ALF derivative of the current order
+     * at all co-latitudes
+     * @param l degree
+     * @return Pointer to the contiguous values at each co-latitude
+     */
+    const T *get_dPlm_bar(int l) const {
+        return _dPlm.data() + row(l);
+    };
+
+    /**
+     * @brief Getter for number of co-latitudes
+     */
+    int get_n() const { return n; };
+};
+
+typedef BasicPlmColumn<double> PlmColumn;
+
+#endif // _PLM_BATCH_HPP_
@@ -0,0 +1,142 @@
+/**
+ * @file PlmCoefficients.hpp
+ *
+ * @brief Header file to define the recursion coefficients of the Associated
+ * Legendre Functions (ALFs)
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _PLM_COEFFICIENTS_HPP_
+#define _PLM_COEFFICIENTS_HPP_
+
+#include "Scalar.hpp"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @class BasicPlmCoefficients
+ *
+ * @brief Immutable table of the coefficients of the FOID recursion for
+ * fully-normalized ALFs.
+ *
+ * This class stores the coefficients defined in Plm.hpp (Holmes and
+ * Featherstone, 2002), which only depend on degree and order:
+ * \f[
+ * a_{lm} = \sqrt{\frac{(2l-1)(2l+1)}{(l-m)(l+m)}} \quad\quad\quad b_{lm} =
+ * \sqrt{\frac{(2l+1)(l+m-1)(l-m+1)}{(l-m)(l+m)(2l-3)}}
+ * \f]
+ * \f[
+ * f_{lm} = \sqrt{\frac{(l^2-m^2)(2l+1)}{2l-1}} \quad\quad\quad s_{l} =
+ * \sqrt{\frac{2l+1}{2l}}
+ * \f]
+ * with \f$ s_1 = \sqrt{3} \f$ so that the sectorial recursion can be started
+ * from \f$ \bar{P}_{0,0} \f$.
+ *
+ * The storage index of a given \f$ (l,m) \f$ pair does not depend on the
+ * maximum degree, so a table computed up to some degree can serve any lower
+ * degree. The static get() method exploits this to share a single,
+ * grow-only table among all users in a thread-safe manner (one table per
+ * scalar type, see Scalar.hpp).
+ */
+template <typename T> class BasicPlmCoefficients {
+    int l_max;        // Maximum degree of the table
+    std::vector<T> a; // FOID recursion coefficients a_lm
+    std::vector<T> b; // FOID recursion coefficients b_lm
+    std::vector<T> f; // Derivatives recursion coefficients f_lm
+    std::vector<T> s; // Sectorial recursion coefficients s_l
+
+    /**
+     * Function that computes global index for internal data structure.
+     * @param l degree
+     * @param m order
+     * @return Global index
+     */
+    size_t lm_idx(int l, int m) const {
+        return (static_cast<size_t>(l) * (l + 1)) / 2 + m;
+    };
+
+  public:
+    /**
+     * Class constructor
+     * @param l_max Maximum degree to which the coefficients are computed
+     */
+    BasicPlmCoefficients(int l_max) : l_max(l_max) {
+        const size_t size = lm_idx(l_max + 1, 0);
+        a.resize(size, 0);
+        b.resize(size, 0);
+        f.resize(size, 0);
+        s.resize(l_max + 1, 0);
+        for (int l = 1; l <= l_max; l++) {
+            s[l] = Scalar<T>::sqrt(l == 1 ? T(3) : (2 * l + T(1)) / (2 * l));
+            for (int m = 0; m < l; m++) {
+                a[lm_idx(l, m)] = Scalar<T>::sqrt(
+                    (2 * l - T(1)) * (2 * l + 1) / ((l - m) * (l + m + T(0))));
+                b[lm_idx(l, m)] =
+                    l - m != 1
+                        ? Scalar<T>::sqrt(
+                              ((2 * l + T(1)) * (l + m - 1) * (l - m - 1)) /
+                              ((l - m) * (l + m + T(0)) * (2 * l - 3)))
+                        : 0;
+                f[lm_idx(l, m)] = Scalar<T>::sqrt((l * l - m * m) *
+                                                  (2 * l + T(1)) / (2 * l - 1));
+            }
+        }
+    };
+
+    /**
+     * @brief Retrieves a shared table valid at least up to a given degree
+     *
+     * The table is computed on first use and only recomputed when a higher
+     * degree is requested. Tables previously handed out remain valid.
+     * @param l_max Minimum degree required
+     * @return Shared pointer to the coefficients table
+     */
+    static std::shared_ptr<const BasicPlmCoefficients> get(int l_max) {
+        static std::mutex mutex;
+        static std::shared_ptr<const BasicPlmCoefficients> table;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!table || table->l_max < l_max) {
+            table = std::make_shared<const BasicPlmCoefficients>(l_max);
+        }
+        return table;
+    };
+
+    /**
+     * @brief Getter for maximum degree of the table
+     */
+    int get_l_max() const { return l_max; };
+
+    /**
+     * @brief Getter for FOID recursion coefficient \f$ a_{lm}, m<l \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_a(int l, int m) const { return a[lm_idx(l, m)]; };
+
+    /**
+     * @brief Getter for FOID recursion coefficient \f$ b_{lm}, m<l \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_b(int l, int m) const { return b[lm_idx(l, m)]; };
+
+    /**
+     * @brief Getter for derivatives recursion coefficient \f$ f_{lm} \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_f(int l, int m) const { return f[lm_idx(l, m)]; };
+
+    /**
+     * @brief Getter for sectorial recursion coefficient \f$ s_l, l>0 \f$
+     * @param l degree
+     */
+    T get_s(int l) const { return s[l]; };
+};
+
+typedef BasicPlmCoefficients<double> PlmCoefficients;
+
+#endif // _PLM_COEFFICIENTS_HPP_
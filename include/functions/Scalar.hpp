@@ -0,0 +1,123 @@
+/**
+ * @file Scalar.hpp
+ *
+ * @brief Header file to define the mathematical functions of the supported
+ * scalar types
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _SCALAR_HPP_
+#define _SCALAR_HPP_
+
+#include <cmath>
+#include <complex>
+#include <limits>
+
+#ifdef FUNCTIONS_QUADMATH
+#include <quadmath.h>
+#endif
+
+/**
+ * @struct ScalarBase
+ *
+ * @brief Operations shared by all scalar types.
+ */
+template <typename T> struct ScalarBase {
+    /**
+     * @brief Power of two \f$ 2^e \f$, evaluated at compile time
+     * @param e Exponent
+     */
+    static constexpr T pow2(int e) {
+        T r = 1;
+        T b = e > 0 ? 2 : 0.5;
+        for (e = e > 0 ? e : -e; e > 0; e >>= 1) {
+            if (e & 1)
+                r *= b;
+            if (e > 1)
+                b *= b;
+        }
+        return r;
+    };
+
+    /**
+     * @brief Square root evaluated at compile time, by Newton iterations
+     * decreasing from above the root until they stall (within one unit in the
+     * last place of the correctly rounded root)
+     * @param x Non-negative argument
+     */
+    static constexpr T const_sqrt(T x) {
+        if (!(x > 0))
+            return 0;
+        T y = x > 1 ? x : T(1);
+        for (int i = 0; i < 10000; i++) {
+            const T z = (y + x / y) / 2;
+            if (!(z < y))
+                break;
+            y = z;
+        }
+        return y;
+    };
+};
+
+/**
+ * @struct Scalar
+ *
+ * @brief Mathematical functions and constants of a scalar type.
+ *
+ * The classes templated on the scalar type (e.g. BasicPlm in Plm.hpp) call the
+ * functions through this struct, so that every operation is carried out in
+ * the precision of the scalar type. The standard floating point types (float,
+ * double and long double) are supported out of the box.
+ *
+ * Quadruple precision (`__float128`) is supported by GCC through libquadmath.
+ * It is enabled by defining `FUNCTIONS_QUADMATH` and linking with
+ * `-lquadmath`.
+ */
+template <typename T> struct Scalar : ScalarBase<T> {
+    static T sqrt(T x) { return std::sqrt(x); };
+    static T cos(T x) { return std::cos(x); };
+    static T sin(T x) { return std::sin(x); };
+    static T acos(T x) { return std::acos(x); };
+    static T atan2(T y, T x) { return std::atan2(y, x); };
+    static T log(T x) { return std::log(x); };
+    static T fabs(T x) { return std::fabs(x); };
+
+    /**
+     * @brief Maximum binary exponent of the type
+     */
+    static constexpr int max_exponent = std::numeric_limits<T>::max_exponent;
+
+    /**
+     * @brief Constant \f$ \pi \f$
+     */
+    static T pi() { return std::acos(T(-1)); };
+
+    /**
+     * @brief Complex number of unit modulus \f$ e^{ix} \f$
+     * @param x Argument
+     */
+    static std::complex<T> polar(T x) {
+        return std::complex<T>(cos(x), sin(x));
+    };
+};
+
+#ifdef FUNCTIONS_QUADMATH
+template <> struct Scalar<__float128> : ScalarBase<__float128> {
+    typedef __float128 T;
+    static T sqrt(T x) { return sqrtq(x); };
+    static T cos(T x) { return cosq(x); };
+    static T sin(T x) { return sinq(x); };
+    static T acos(T x) { return acosq(x); };
+    static T atan2(T y, T x) { return atan2q(y, x); };
+    static T log(T x) { return logq(x); };
+    static T fabs(T x) { return fabsq(x); };
+    static constexpr int max_exponent = FLT128_MAX_EXP;
+    static T pi() { return acosq(-1); };
+    static std::complex<T> polar(T x) {
+        return std::complex<T>(cos(x), sin(x));
+    };
+};
+#endif
+
+#endif // _SCALAR_HPP_
@@ -0,0 +1,318 @@
+/**
+ * @file StaticPlm.hpp
+ *
+ * @brief Header file to define Associated Legendre Functions (ALFs) of a
+ * maximum degree fixed at compile time
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _STATIC_PLM_HPP_
+#define _STATIC_PLM_HPP_
+
+#include "Scalar.hpp"
+
+#include <array>
+
+/**
+ * @struct StaticPlmCoefficients
+ *
+ * @brief Coefficients of the FOID recursion (see PlmCoefficients.hpp) and
+ * normalization constants (see Nlm.hpp) up to degree L, computed at compile
+ * time.
+ *
+ * @tparam L Maximum degree
+ * @tparam T Scalar type (see Scalar.hpp)
+ */
+template <int L, typename T> struct StaticPlmCoefficients {
+    static constexpr int size = (L + 1) * (L + 2) / 2;
+
+    std::array<T, size> a{};  // FOID recursion coefficients a_lm
+    std::array<T, size> b{};  // FOID recursion coefficients b_lm
+    std::array<T, size> f{};  // Derivatives recursion coefficients f_lm
+    std::array<T, size> N{};  // Normalization constants N_lm
+    std::array<T, L + 1> s{}; // Sectorial recursion coefficients s_l
+
+    /**
+     * Function that computes global index for internal data structure.
+     * @param l degree
+     * @param m order
+     * @return Global index
+     */
+    static constexpr int lm_idx(int l, int m) { return l * (l + 1) / 2 + m; };
+
+    /**
+     * Class constructor, meant to be evaluated at compile time
+     */
+    constexpr StaticPlmCoefficients() {
+        for (int l = 1; l <= L; l++) {
+            s[l] = sqrt(l == 1 ? T(3) : (2 * l + T(1)) / (2 * l));
+            for (int m = 0; m < l; m++) {
+                a[lm_idx(l, m)] =
+                    sqrt((2 * l - T(1)) * (2 * l + 1) / ((l - m) * T(l + m)));
+                b[lm_idx(l, m)] =
+                    l - m != 1 ? sqrt(((2 * l + T(1)) * (l + m - 1) *
+                                       (l - m - 1)) /
+                                      ((l - m) * T(l + m) * (2 * l - 3)))
+                               : 0;
+                f[lm_idx(l, m)] =
+                    sqrt((l * l - m * m) * (2 * l + T(1)) / (2 * l - 1));
+            }
+        }
+        // Same recursion as Nlm
+        for (int l = 0; l <= L; l++) {
+            N[lm_idx(l, 0)] = sqrt(2 * l + 1);
+            for (int m = 1; m <= l; m++) {
+                N[lm_idx(l, m)] =
+                    N[lm_idx(l, m - 1)] * sqrt(T(1) / ((l - m + 1) * T(l + m)));
+            }
+            for (int m = 1; m <= l; m++) {
+                N[lm_idx(l, m)] *= sqrt(2);
+            }
+        }
+    };
+
+  private:
+    static constexpr T sqrt(T x) { return Scalar<T>::const_sqrt(x); };
+};
+
+/**
+ * @class StaticPlm
+ *
+ * @brief Class that computes and stores the Associated Legendre Functions
+ * (ALFs) and its derivatives up to a maximum degree known at compile time.
+ *
+ * This class applies the same recursions as Plm (see Plm.hpp) and offers the
+ * same getters, but it is meant for the low degrees (e.g. 2 to 20) of
+ * high-rate orbit propagators, where the loops, index arithmetic and heap
+ * allocations of Plm cost more than the recursions themselves. Here the
+ * coefficients are constexpr tables and the ALFs are stored in fixed-size
+ * arrays, so an instance lives on the stack, loops have constant bounds and
+ * the compiler is free to unroll them completely.
+ *
+ * The extended range of Plm is not provided: the sectorial values only
+ * underflow for degrees far beyond the intended use.
+ *
+ * @tparam L Maximum degree
+ * @tparam T Scalar type (see Scalar.hpp)
+ */
+template <int L, typename T = double> class StaticPlm {
+    static_assert(L >= 0, "StaticPlm: maximum degree must be non-negative");
+
+    typedef StaticPlmCoefficients<L, T> Coefficients;
+    static constexpr int size = Coefficients::size;
+    static constexpr Coefficients coeffs{}; // Recursion coefficients
+
+    T theta = 0;                     // Co-latitude
+    bool derivatives = false;        // Flag to compute derivatives
+    bool second_derivatives = false; // Flag to compute 2nd order derivatives
+
+    std::array<T, size> _Plm{};   // Fully-normalized ALFs
+    std::array<T, size> _dPlm{};  // Derivatives
+    std::array<T, size> _ddPlm{}; // 2nd order derivatives
+
+    static constexpr int lm_idx(int l, int m) {
+        return Coefficients::lm_idx(l, m);
+    };
+
+    /**
+     * Function that computes the equatorial parity of an ALF.
+     * @param l degree
+     * @param m order
+     * @return \f$ (-1)^{l+m} \f$
+     */
+    static T parity(int l, int m) { return (l + m) % 2 == 0 ? 1 : -1; };
+
+  public:
+    /**
+     * Default constructor
+     */
+    StaticPlm() {};
+
+    /**
+     * Class constructor
+     * @param theta Co-latitude at which the ALFs (and its derivatives) are
+     * evaluated
+     * @param derivatives Flag to indicate whether derivatives are computed or
+     * not
+     * @param second_derivatives Flag to indicate whether 2nd order derivatives
+     * are computed or not
+     */
+    StaticPlm(T theta, bool derivatives = false,
+              bool second_derivatives = false)
+        : derivatives(derivatives),
+          second_derivatives(derivatives && second_derivatives) {
+        evaluate(theta);
+    };
+
+    /**
+     * @brief Re-evaluates the ALFs (and its derivatives) in place at a new
+     * co-latitude, keeping the derivative flags of the constructor
+     * @param theta Co-latitude at which the ALFs (and its derivatives) are
+     * evaluated
+     */
+    void evaluate(T theta) {
+        this->theta = theta;
+        const T t = Scalar<T>::cos(theta);
+        const T u = Scalar<T>::sin(theta);
+        // Same recursions as Plm, degree by degree: the terms of a row are
+        // independent and contiguous, so the inner loop vectorizes instead
+        // of chaining the latency of each column recursion
+        _Plm[0] = 1;
+        for (int l = 1; l <= L; l++) {
+            for (int m = 0; m < l - 1; m++) {
+                _Plm[lm_idx(l, m)] =
+                    coeffs.a[lm_idx(l, m)] * t * _Plm[lm_idx(l - 1, m)] -
+                    coeffs.b[lm_idx(l, m)] * _Plm[lm_idx(l - 2, m)];
+            }
+            // Terms right below the diagonal and sectorial term
+            _Plm[lm_idx(l, l - 1)] =
+                coeffs.a[lm_idx(l, l - 1)] * t * _Plm[lm_idx(l - 1, l - 1)];
+            _Plm[lm_idx(l, l)] = coeffs.s[l] * u * _Plm[lm_idx(l - 1, l - 1)];
+        }
+        if (!derivatives)
+            return;
+        const T inv_u = T(1) / u;
+        for (int l = 0; l <= L; l++) {
+            for (int m = 0; m < l; m++) {
+                _dPlm[lm_idx(l, m)] =
+                    inv_u * (l * t * _Plm[lm_idx(l, m)] -
+                             coeffs.f[lm_idx(l, m)] * _Plm[lm_idx(l - 1, m)]);
+            }
+            _dPlm[lm_idx(l, l)] = l * t * inv_u * _Plm[lm_idx(l, l)];
+        }
+        if (!second_derivatives)
+            return;
+        for (int l = 0; l <= L; l++) {
+            for (int m = 0; m < l; m++) {
+                _ddPlm[lm_idx(l, m)] =
+                    inv_u *
+                        ((l - 1) * t * _dPlm[lm_idx(l, m)] -
+                         coeffs.f[lm_idx(l, m)] * _dPlm[lm_idx(l - 1, m)]) -
+                    l * _Plm[lm_idx(l, m)];
+            }
+            _ddPlm[lm_idx(l, l)] = (l - 1) * t * inv_u * _dPlm[lm_idx(l, l)] -
+                                   l * _Plm[lm_idx(l, l)];
+        }
+    };
+
+    /**
+     * @brief Getter for maximum degree
+     */
+    static constexpr int get_l_max() { return L; };
+
+    /**
+     * @brief Getter for fully-normalized ALF
+     * @param l degree
+     * @param m order
+     */
+    T get_Plm_bar(int l, int m) const { return _Plm[lm_idx(l, m)]; };
+
+    /**
+     * @brief Getter for unnormalized ALF
+     * @param l degree
+     * @param m order
+     */
+    T get_Plm(int l, int m) const {
+        return _Plm[lm_idx(l, m)] / coeffs.N[lm_idx(l, m)];
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF derivative
+     * @param l degree
+     * @param m order
+     */
+    T get_dPlm_bar(int l, int m) const { return _dPlm[lm_idx(l, m)]; };
+
+    /**
+     * @brief Getter for unnormalized ALF derivative
+     * @param l degree
+     * @param m order
+     */
+    T get_dPlm(int l, int m) const {
+        return _dPlm[lm_idx(l, m)] / coeffs.N[lm_idx(l, m)];
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF 2nd order derivative
+     * @param l degree
+     * @param m order
+     */
+    T get_ddPlm_bar(int l, int m) const { return _ddPlm[lm_idx(l, m)]; };
+
+    /**
+     * @brief Getter for unnormalized ALF 2nd order derivative
+     * @param l degree
+     * @param m order
+     */
+    T get_ddPlm(int l, int m) const {
+        return _ddPlm[lm_idx(l, m)] / coeffs.N[lm_idx(l, m)];
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF at the mirrored co-latitude
+     * \f$ \pi-\theta \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_Plm_bar_mirror(int l, int m) const {
+        return parity(l, m) * get_Plm_bar(l, m);
+    };
+
+    /**
+     * @brief Getter for unnormalized ALF at the mirrored co-latitude
+     * \f$ \pi-\theta \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_Plm_mirror(int l, int m) const {
+        return parity(l, m) * get_Plm(l, m);
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF derivative at the mirrored
+     * co-latitude \f$ \pi-\theta \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_dPlm_bar_mirror(int l, int m) const {
+        return -parity(l, m) * get_dPlm_bar(l, m);
+    };
+
+    /**
+     * @brief Getter for unnormalized ALF derivative at the mirrored
+     * co-latitude \f$ \pi-\theta \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_dPlm_mirror(int l, int m) const {
+        return -parity(l, m) * get_dPlm(l, m);
+    };
+
+    /**
+     * @brief Getter for fully-normalized ALF 2nd order derivative at the
+     * mirrored co-latitude \f$ \pi-\theta \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_ddPlm_bar_mirror(int l, int m) const {
+        return parity(l, m) * get_ddPlm_bar(l, m);
+    };
+
+    /**
+     * @brief Getter for unnormalized ALF 2nd order derivative at the mirrored
+     * co-latitude \f$ \pi-\theta \f$
+     * @param l degree
+     * @param m order
+     */
+    T get_ddPlm_mirror(int l, int m) const {
+        return parity(l, m) * get_ddPlm(l, m);
+    };
+
+    /**
+     * @brief Getter for associated colatitude
+     */
+    T get_theta() const { return theta; };
+};
+
+#endif // _STATIC_PLM_HPP_
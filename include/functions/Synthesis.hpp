@@ -0,0 +1,149 @@
+/**
+ * @file Synthesis.hpp
+ *
+ * @brief Header file to define spherical harmonic synthesis through Clenshaw
+ * summation
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _SYNTHESIS_HPP_
+#define _SYNTHESIS_HPP_
+
+#include "Clm.hpp"
+#include "PlmCoefficients.hpp"
+
+#include <cmath>
+#include <memory>
+
+/**
+ * @class Synthesis
+ *
+ * @brief Class that evaluates a spherical harmonic expansion and its
+ * co-latitude derivatives at a given point without computing the ALFs.
+ *
+ * The expansion defined in Clm.hpp is evaluated order by order:
+ * \f[
+ * f(\theta, \lambda) = \sum_{m=0}^{L} \sum_{l=m}^{L} c_{lm}
+ * \bar{P}_{lm}(\theta) \quad\quad c_{lm} = \bar{C}_{lm} \cos{m\lambda} +
+ * \bar{S}_{lm} \sin{m\lambda}
+ * \f]
+ * Since the ALFs of a fixed order satisfy the FOID recursion described in
+ * Plm.hpp (with \f$ \bar{P}_{m-1,m} = 0 \f$), the inner sum is computed by
+ * Clenshaw summation (Holmes and Featherstone, 2002, sec. 3):
+ * \f[
+ * y_l = c_{lm} + a_{l+1,m} t y_{l+1} - b_{l+2,m} y_{l+2} \quad\quad
+ * \sum_{l=m}^{L} c_{lm} \bar{P}_{lm}(\theta) = y_m \bar{P}_{mm}(\theta)
+ * \f]
+ * with \f$ y_{L+1} = y_{L+2} = 0 \f$. The co-latitude derivatives follow from
+ * differentiating the Clenshaw recursion, so neither the ALFs nor their
+ * derivatives are ever stored. The derivatives of the sectorial terms are
+ * computed from lower sectorial terms, avoiding any division by
+ * \f$ u=\sin{\theta} \f$.
+ *
+ * The recursion coefficients are shared with Plm (see PlmCoefficients.hpp).
+ */
+class Synthesis {
+    double theta;   // Co-latitude
+    double lambda;  // Longitude
+    double V = 0;   // Synthesized function
+    double dV = 0;  // Co-latitude derivative
+    double ddV = 0; // Co-latitude 2nd order derivative
+
+  public:
+    /**
+     * Class constructor
+     * @param clm Spherical harmonic coefficients
+     * @param theta Co-latitude at which the expansion is evaluated
+     * @param lambda Longitude at which the expansion is evaluated
+     * @param derivatives Flag to indicate whether derivatives are computed or
+     * not
+     * @param second_derivatives Flag to indicate whether 2nd order derivatives
+     * are computed or not
+     */
+    Synthesis(const Clm &clm, double theta, double lambda,
+              bool derivatives = false, bool second_derivatives = false)
+        : theta(theta), lambda(lambda) {
+        const int l_max = clm.get_l_max();
+        std::shared_ptr<const PlmCoefficients> coeffs =
+            PlmCoefficients::get(l_max + 2);
+        second_derivatives = derivatives && second_derivatives;
+        // Define cosine, sine
+        const double t = cos(theta);
+        const double u = sin(theta);
+        // Sectorial ALFs of current and two previous orders
+        double P_mm = 1, P_1 = 0, P_2 = 0;
+        for (int m = 0; m <= l_max; m++) { // Fix order
+            // Sectorial recursion
+            if (m > 0) {
+                P_2 = P_1;
+                P_1 = P_mm;
+                P_mm = coeffs->get_s(m) * u * P_1;
+            }
+            // Clenshaw summation over degree
+            const double cos_m = cos(m * lambda);
+            const double sin_m = sin(m * lambda);
+            double y = 0, y_1 = 0, y_2 = 0;
+            double dy = 0, dy_1 = 0, dy_2 = 0;
+            double ddy = 0, ddy_1 = 0, ddy_2 = 0;
+            for (int l = l_max; l >= m; l--) {
+                const double a = coeffs->get_a(l + 1, m);
+                const double b = coeffs->get_b(l + 2, m);
+                y = clm.get_C(l, m) * cos_m + clm.get_S(l, m) * sin_m +
+                    a * t * y_1 - b * y_2;
+                if (second_derivatives) {
+                    ddy = a * (t * ddy_1 - 2 * u * dy_1 - t * y_1) - b * ddy_2;
+                    ddy_2 = ddy_1;
+                    ddy_1 = ddy;
+                }
+                if (derivatives) {
+                    dy = a * (t * dy_1 - u * y_1) - b * dy_2;
+                    dy_2 = dy_1;
+                    dy_1 = dy;
+                }
+                y_2 = y_1;
+                y_1 = y;
+            }
+            V += P_mm * y;
+            if (!derivatives)
+                continue;
+            // Derivatives of sectorial terms
+            const double dP_mm = m > 0 ? m * t * coeffs->get_s(m) * P_1 : 0;
+            dV += dP_mm * y + P_mm * dy;
+            if (!second_derivatives)
+                continue;
+            double ddP_mm = -m * P_mm;
+            if (m > 1)
+                ddP_mm += m * (m - 1) * t * t * coeffs->get_s(m) *
+                          coeffs->get_s(m - 1) * P_2;
+            ddV += ddP_mm * y + 2 * dP_mm * dy + P_mm * ddy;
+        }
+    };
+
+    /**
+     * @brief Getter for synthesized function
+     */
+    double get_V() const { return V; };
+
+    /**
+     * @brief Getter for synthesized function co-latitude derivative
+     */
+    double get_dV() const { return dV; };
+
+    /**
+     * @brief Getter for synthesized function co-latitude 2nd order derivative
+     */
+    double get_ddV() const { return ddV; };
+
+    /**
+     * @brief Getter for associated co-latitude
+     */
+    double get_theta() const { return theta; };
+
+    /**
+     * @brief Getter for associated longitude
+     */
+    double get_lambda() const { return lambda; };
+};
+
+#endif // _SYNTHESIS_HPP_
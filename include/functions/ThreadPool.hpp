@@ -0,0 +1,138 @@
+/**
+ * @file ThreadPool.hpp
+ *
+ * @brief Header file to define a pool of worker threads
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _THREAD_POOL_HPP_
+#define _THREAD_POOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ *
+ * @brief Class that keeps a set of worker threads alive to run batches of
+ * independent tasks.
+ *
+ * A batch of tasks \f$ 0, \dots, n-1 \f$ is executed by the workers and the
+ * calling thread, which pick the next pending task from a shared counter. As a
+ * result, tasks are dynamically balanced among threads: splitting the work in
+ * a few more tasks than threads, and issuing the most expensive tasks first,
+ * keeps every thread busy until the end of the batch.
+ *
+ * Tasks must be independent and must not throw. Batches issued by different
+ * threads on the same pool are serialized.
+ */
+class ThreadPool {
+    std::vector<std::thread> workers; // Worker threads
+    std::mutex run_mutex;             // Serializes batches
+    std::mutex mutex;                 // Protects the batch state below
+    std::condition_variable cv_task;  // Signals a new batch (or stop)
+    std::condition_variable cv_done;  // Signals the end of a batch
+
+    const std::function<void(int)> *task = nullptr; // Current batch
+    int n_tasks = 0;                                // Tasks in batch
+    std::atomic<int> next{0};                       // Next pending task
+
+    int active = 0;          // Workers still running the batch
+    unsigned generation = 0; // Batch counter
+    bool stop = false;       // Destruction flag
+
+    /**
+     * Function that runs pending tasks of the current batch.
+     */
+    void work() {
+        for (int i = next++; i < n_tasks; i = next++) {
+            (*task)(i);
+        }
+    };
+
+    /**
+     * Function that runs on every worker thread.
+     */
+    void loop() {
+        unsigned seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cv_task.wait(lock, [&] { return stop || generation != seen; });
+            if (stop)
+                return;
+            seen = generation;
+            lock.unlock();
+            work();
+            lock.lock();
+            if (--active == 0)
+                cv_done.notify_all();
+        }
+    };
+
+  public:
+    /**
+     * Class constructor
+     * @param n_threads Number of threads running the tasks, including the
+     * calling thread (by default, the number of hardware threads)
+     */
+    ThreadPool(int n_threads = std::thread::hardware_concurrency()) {
+        for (int k = 1; k < n_threads; k++) {
+            workers.emplace_back(&ThreadPool::loop, this);
+        }
+    };
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Destructor
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cv_task.notify_all();
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+    };
+
+    /**
+     * @brief Runs a batch of tasks and waits for its completion
+     * @param n Number of tasks
+     * @param f Task, called once for each index \f$ 0 \leq i < n \f$
+     */
+    void run(int n, const std::function<void(int)> &f) {
+        if (workers.empty() || n <= 1) {
+            for (int i = 0; i < n; i++) {
+                f(i);
+            }
+            return;
+        }
+        std::lock_guard<std::mutex> run_lock(run_mutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &f;
+            n_tasks = n;
+            next = 0;
+            active = workers.size();
+            generation++;
+        }
+        cv_task.notify_all();
+        work();
+        std::unique_lock<std::mutex> lock(mutex);
+        cv_done.wait(lock, [&] { return active == 0; });
+    };
+
+    /**
+     * @brief Getter for number of threads, including the calling thread
+     */
+    int get_n_threads() const { return workers.size() + 1; };
+};
+
+#endif // _THREAD_POOL_HPP_
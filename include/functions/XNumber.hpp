@@ -0,0 +1,139 @@
+/**
+ * @file XNumber.hpp
+ *
+ * @brief Header file to define extended exponent floating point numbers
+ *
+ * @author Gabriel Valles
+ * @date 2025-02-17
+ */
+#ifndef _XNUMBER_HPP_
+#define _XNUMBER_HPP_
+
+#include "Scalar.hpp"
+
+/**
+ * @class BasicXNumber
+ *
+ * @brief Floating point number with extended exponent range (Fukushima, 2012).
+ *
+ * An X-number is a pair \f$ (x, i) \f$ of a double and an integer representing
+ * the value \f$ x B^i \f$ with \f$ B = 2^{960} \f$. The double is kept within
+ * \f$ [B^{-1/2}, B^{1/2}) \f$ in absolute value, so that products and sums
+ * with ordinary doubles never underflow. Since \f$ B \f$ is a power of two,
+ * the scaling does not introduce any rounding error.
+ *
+ * This enables the computation of ALFs to ultra-high degrees, where the
+ * sectorial values underflow the range of doubles.
+ *
+ * Other scalar types (see Scalar.hpp) use the same construction with
+ * \f$ B = 2^{15 E/16} \f$, being \f$ 2^E \f$ the overflow threshold of the
+ * type (e.g. \f$ B = 2^{120} \f$ for float).
+ */
+template <typename T> class BasicXNumber {
+    T x;   // Significand
+    int i; // Exponent in powers of B
+
+  public:
+    /**
+     * @brief Binary exponent of B
+     */
+    static constexpr int exponent = Scalar<T>::max_exponent / 16 * 15;
+
+  private:
+    static constexpr T BIG = Scalar<T>::pow2(exponent);        // B
+    static constexpr T BIGI = Scalar<T>::pow2(-exponent);      // 1/B
+    static constexpr T BIGS = Scalar<T>::pow2(exponent / 2);   // B^(1/2)
+    static constexpr T BIGSI = Scalar<T>::pow2(-exponent / 2); // B^(-1/2)
+
+    /**
+     * Function that brings back the significand into its range. A single
+     * step suffices after a product or a sum with bounded factors.
+     */
+    void normalize() {
+        const T w = Scalar<T>::fabs(x);
+        if (w >= BIGS) {
+            x *= BIGI;
+            i++;
+        } else if (w < BIGSI && x != 0) {
+            x *= BIG;
+            i--;
+        }
+    };
+
+  public:
+    /**
+     * Class constructor
+     * @param x Significand
+     * @param i Exponent in powers of \f$ B \f$
+     */
+    BasicXNumber(T x = 0, int i = 0) : x(x), i(i) { normalize(); };
+
+    /**
+     * @brief Product by a double
+     * @param f Factor, assumed to be within the range of the significand
+     */
+    BasicXNumber operator*(T f) const { return BasicXNumber(x * f, i); };
+
+    /**
+     * @brief Product of two X-numbers
+     * @param Y Factor
+     */
+    BasicXNumber operator*(const BasicXNumber &Y) const {
+        return BasicXNumber(x * Y.x, i + Y.i);
+    };
+
+    /**
+     * @brief Linear combination \f$ f X + g Y \f$ of two X-numbers
+     * @param f Factor of X
+     * @param X First X-number
+     * @param g Factor of Y
+     * @param Y Second X-number
+     */
+    static BasicXNumber lsum2(T f, const BasicXNumber &X, T g,
+                              const BasicXNumber &Y) {
+        // A zero carries no exponent
+        if (X.x == 0)
+            return Y * g;
+        if (Y.x == 0)
+            return X * f;
+        const int id = X.i - Y.i;
+        if (id == 0) {
+            return BasicXNumber(f * X.x + g * Y.x, X.i);
+        } else if (id == 1) {
+            return BasicXNumber(f * X.x + g * (Y.x * BIGI), X.i);
+        } else if (id == -1) {
+            return BasicXNumber(f * (X.x * BIGI) + g * Y.x, Y.i);
+        } else if (id > 1) {
+            return BasicXNumber(f * X.x, X.i);
+        }
+        return BasicXNumber(g * Y.x, Y.i);
+    };
+
+    /**
+     * @brief Getter for significand
+     */
+    T get_x() const { return x; };
+
+    /**
+     * @brief Getter for exponent in powers of \f$ B \f$
+     */
+    int get_i() const { return i; };
+
+    /**
+     * @brief Conversion to the scalar type, flushing to zero values below its
+     * range
+     */
+    T to_double() const {
+        if (i == 0)
+            return x;
+        if (i == -1)
+            return x * BIGI;
+        if (i < -1)
+            return 0;
+        return x * BIG;
+    };
+};
+
+typedef BasicXNumber<double> XNumber;
+
+#endif // _XNUMBER_HPP_
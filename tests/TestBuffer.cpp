@@ -0,0 +1,38 @@
+#include <limits>
+
+#include <functions>
+#include <gtest/gtest.h>
+
+TEST(Buffer, Storage)
+{
+    for (auto kind : {Storage::Heap, Storage::HugePages, Storage::File})
+    {
+        Buffer buffer(1000, {kind});
+        for (size_t i = 0; i < buffer.size(); i++)
+        {
+            buffer[i] = i;
+        }
+        Buffer copy(buffer);
+        ASSERT_EQ(copy.get_storage().kind, kind);
+        Buffer moved(std::move(buffer));
+        ASSERT_EQ(buffer.size(), 0);
+        for (size_t i = 0; i < copy.size(); i++)
+        {
+            ASSERT_EQ(copy[i], i);
+            ASSERT_EQ(moved[i], i);
+        }
+    }
+}
+
+TEST(Buffer, Degree2190)
+{
+    // Inclination functions table for EGM2008-class degrees (~28 GB) mapped
+    // from a sparse file, only the first and last pages are touched
+    const size_t size = Flmp::size(2190);
+    ASSERT_GT(size, size_t(std::numeric_limits<int>::max()));
+    Buffer buffer(size, {Storage::File});
+    buffer[0] = 1;
+    buffer[size - 1] = 2;
+    ASSERT_EQ(buffer[0], 1);
+    ASSERT_EQ(buffer[size - 1], 2);
+}
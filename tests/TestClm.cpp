@@ -0,0 +1,16 @@
+#include <functions>
+#include <gtest/gtest.h>
+
+TEST(Clm, Value)
+{
+    Clm clm(10);
+    ASSERT_EQ(clm.get_l_max(), 10);
+    ASSERT_EQ(clm.get_C(7, 3), 0);
+    clm.set_C(7, 3, 1.5);
+    clm.set_S(7, 3, -2.5);
+    clm.set_C(10, 10, 3.5);
+    ASSERT_EQ(clm.get_C(7, 3), 1.5);
+    ASSERT_EQ(clm.get_S(7, 3), -2.5);
+    ASSERT_EQ(clm.get_C(10, 10), 3.5);
+    ASSERT_EQ(clm.get_S(10, 10), 0);
+}
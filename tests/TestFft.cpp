@@ -0,0 +1,238 @@
+#include <random>
+
+#include <functions>
+#include <gtest/gtest.h>
+
+/**
+ * Function that computes a reference discrete Fourier transform.
+ * @param x Data to be transformed
+ * @return Transformed data
+ */
+std::vector<std::complex<double>>
+dft(const std::vector<std::complex<double>> &x)
+{
+    const int n = x.size();
+    std::vector<std::complex<double>> X(n);
+    for (int k = 0; k < n; k++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            const long long jk = (static_cast<long long>(j) * k) % n;
+            X[k] += x[j] * std::polar(1.0, -2 * M_PI * jk / n);
+        }
+    }
+    return X;
+}
+
+TEST(Fft, Complex)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    for (int n : {1, 2, 4, 8, 16, 32, 64, 1024, 3, 5, 7, 12, 45, 97, 210,
+                  343, 840})
+    {
+        std::vector<std::complex<double>> x(n), X(n), y(n);
+        for (int j = 0; j < n; j++)
+        {
+            x[j] = {dist(gen), dist(gen)};
+        }
+        Fft fft(n);
+        fft.forward(x.data(), X.data());
+        std::vector<std::complex<double>> X_ref = dft(x);
+        for (int k = 0; k < n; k++)
+        {
+            ASSERT_NEAR(std::abs(X[k] - X_ref[k]), 0, 1e-12);
+        }
+        fft.inverse(X.data(), y.data());
+        for (int j = 0; j < n; j++)
+        {
+            ASSERT_NEAR(std::abs(y[j] / double(n) - x[j]), 0, 1e-14);
+        }
+    }
+}
+
+TEST(Fft, Real)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    for (int n : {1, 2, 4, 8, 16, 32, 64, 1024, 3, 5, 7, 12, 45, 97, 210,
+                  343, 840})
+    {
+        std::vector<double> x(n), y(n);
+        std::vector<std::complex<double>> x_c(n), X(n / 2 + 1);
+        for (int j = 0; j < n; j++)
+        {
+            x_c[j] = x[j] = dist(gen);
+        }
+        RealFft fft(n);
+        fft.forward(x.data(), X.data());
+        std::vector<std::complex<double>> X_ref = dft(x_c);
+        for (int k = 0; k <= n / 2; k++)
+        {
+            ASSERT_NEAR(std::abs(X[k] - X_ref[k]), 0, 1e-12);
+        }
+        fft.inverse(X.data(), y.data());
+        for (int j = 0; j < n; j++)
+        {
+            ASSERT_NEAR(y[j] / n, x[j], 1e-14);
+        }
+    }
+}
+
+TEST(Fft, LongDouble)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    for (int n : {64, 45, 210})
+    {
+        std::vector<long double> x(n), y(n);
+        std::vector<std::complex<double>> x_c(n);
+        std::vector<std::complex<long double>> X(n / 2 + 1);
+        for (int j = 0; j < n; j++)
+        {
+            x_c[j] = x[j] = dist(gen);
+        }
+        BasicRealFft<long double> fft(n);
+        fft.forward(x.data(), X.data());
+        std::vector<std::complex<double>> X_ref = dft(x_c);
+        for (int k = 0; k <= n / 2; k++)
+        {
+            ASSERT_NEAR(X[k].real(), X_ref[k].real(), 1e-12);
+            ASSERT_NEAR(X[k].imag(), X_ref[k].imag(), 1e-12);
+        }
+        // Round trip to extended precision
+        fft.inverse(X.data(), y.data());
+        for (int j = 0; j < n; j++)
+        {
+            ASSERT_NEAR(y[j] / n, x[j], 1e-17);
+        }
+    }
+}
+
+TEST(Fft, Split)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    for (int n : {2, 4, 8, 256, 512, 12, 45})
+    {
+        // Complex transforms of split data, in place
+        std::vector<std::complex<double>> x(n), X(n);
+        std::vector<double> re(n), im(n);
+        for (int j = 0; j < n; j++)
+        {
+            x[j] = {dist(gen), dist(gen)};
+            re[j] = x[j].real();
+            im[j] = x[j].imag();
+        }
+        Fft fft(n);
+        fft.forward(x.data(), X.data());
+        fft.forward(re.data(), im.data(), re.data(), im.data());
+        for (int k = 0; k < n; k++)
+        {
+            ASSERT_NEAR(re[k], X[k].real(), 1e-12);
+            ASSERT_NEAR(im[k], X[k].imag(), 1e-12);
+        }
+        fft.inverse(re.data(), im.data(), re.data(), im.data());
+        for (int j = 0; j < n; j++)
+        {
+            ASSERT_NEAR(re[j] / n, x[j].real(), 1e-14);
+            ASSERT_NEAR(im[j] / n, x[j].imag(), 1e-14);
+        }
+        // Real transforms with split spectrum
+        std::vector<double> y(n), y_inv(n), Y_re(n / 2 + 1), Y_im(n / 2 + 1);
+        std::vector<std::complex<double>> Y(n / 2 + 1);
+        for (int j = 0; j < n; j++)
+        {
+            y[j] = dist(gen);
+        }
+        RealFft rfft(n);
+        rfft.forward(y.data(), Y.data());
+        rfft.forward(y.data(), Y_re.data(), Y_im.data());
+        for (int k = 0; k <= n / 2; k++)
+        {
+            ASSERT_NEAR(Y_re[k], Y[k].real(), 1e-14);
+            ASSERT_NEAR(Y_im[k], Y[k].imag(), 1e-14);
+        }
+        rfft.inverse(Y_re.data(), Y_im.data(), y_inv.data());
+        for (int j = 0; j < n; j++)
+        {
+            ASSERT_NEAR(y_inv[j] / n, y[j], 1e-14);
+        }
+    }
+}
+
+TEST(Fft, Batch)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    const int batch = 5;
+    for (int n : {1, 2, 4, 8, 16, 64, 1024, 3, 12, 45, 97, 210})
+    {
+        // Interleaved data: sample j of transform b at j * batch + b
+        std::vector<double> re(n * batch), im(n * batch), x(n * batch);
+        for (int j = 0; j < n * batch; j++)
+        {
+            re[j] = dist(gen);
+            im[j] = dist(gen);
+            x[j] = dist(gen);
+        }
+        Fft fft(n);
+        std::vector<double> y_re(n * batch), y_im(n * batch);
+        fft.forward_batch(batch, re.data(), im.data(), y_re.data(),
+                          y_im.data());
+        RealFft rfft(n);
+        const int h = n / 2 + 1;
+        std::vector<double> X_re(h * batch), X_im(h * batch);
+        rfft.forward_batch(batch, x.data(), X_re.data(), X_im.data());
+        for (int b = 0; b < batch; b++)
+        {
+            // Each transform of the batch against a single transform
+            std::vector<double> re_b(n), im_b(n), x_b(n);
+            for (int j = 0; j < n; j++)
+            {
+                re_b[j] = re[j * batch + b];
+                im_b[j] = im[j * batch + b];
+                x_b[j] = x[j * batch + b];
+            }
+            fft.forward(re_b.data(), im_b.data(), re_b.data(), im_b.data());
+            for (int k = 0; k < n; k++)
+            {
+                ASSERT_NEAR(y_re[k * batch + b], re_b[k], 1e-12);
+                ASSERT_NEAR(y_im[k * batch + b], im_b[k], 1e-12);
+            }
+            std::vector<double> Xr_b(h), Xi_b(h);
+            rfft.forward(x_b.data(), Xr_b.data(), Xi_b.data());
+            for (int k = 0; k < h; k++)
+            {
+                ASSERT_NEAR(X_re[k * batch + b], Xr_b[k], 1e-12);
+                ASSERT_NEAR(X_im[k * batch + b], Xi_b[k], 1e-12);
+            }
+        }
+        // The inverse batch undoes the forward batch
+        fft.inverse_batch(batch, y_re.data(), y_im.data(), y_re.data(),
+                          y_im.data());
+        for (int j = 0; j < n * batch; j++)
+        {
+            ASSERT_NEAR(y_re[j] / n, re[j], 1e-12);
+            ASSERT_NEAR(y_im[j] / n, im[j], 1e-12);
+        }
+    }
+}
+
+TEST(Fft, FastSize)
+{
+    ASSERT_TRUE(Fft::is_fast(1));
+    ASSERT_TRUE(Fft::is_fast(2 * 3 * 5 * 7 * 64));
+    ASSERT_FALSE(Fft::is_fast(11));
+    ASSERT_FALSE(Fft::is_fast(2 * 97));
+    ASSERT_EQ(Fft::fast_size(1027), 1029);
+    ASSERT_EQ(Fft::fast_size(1024), 1024);
+    ASSERT_EQ(Fft::fast_size(11), 12);
+    for (int n = 1; n < 2000; n++)
+    {
+        const int m = Fft::fast_size(n);
+        ASSERT_GE(m, n);
+        ASSERT_TRUE(Fft::is_fast(m));
+        ASSERT_TRUE(m == n || !Fft::is_fast(n));
+    }
+}
@@ -66,4 +66,177 @@ TEST(Flmp, Derivative100)
     ASSERT_NEAR(std::abs(flmp.get_dFlmp(69, 15, 34)), 14.285109814165770, 1e-10);
     ASSERT_NEAR(std::abs(flmp.get_dFlmp(71, 15, 35)), 14.262965486747120, 1e-10);
     ASSERT_NEAR(std::abs(flmp.get_dFlmp(73, 15, 36)), 5.729761501008049, 1e-10);
-}
\ No newline at end of file
+}
+
+TEST(Flmp, Storage)
+{
+    double I = 89 * M_PI / 180;
+    Flmp heap(40, I, true);
+    Flmp huge_pages(40, I, true, {Storage::HugePages});
+    Flmp file(40, I, true, {Storage::File});
+    Flmp copy;
+    copy = file;
+    for (int l = 0; l <= 40; l++)
+    {
+        for (int m = 0; m <= l; m++)
+        {
+            for (int p = 0; p <= l; p++)
+            {
+                ASSERT_EQ(heap.get_Flmp(l, m, p), huge_pages.get_Flmp(l, m, p));
+                ASSERT_EQ(heap.get_Flmp(l, m, p), copy.get_Flmp(l, m, p));
+                ASSERT_EQ(heap.get_dFlmp(l, m, p), file.get_dFlmp(l, m, p));
+            }
+        }
+    }
+}
+
+TEST(Flmp, Size)
+{
+    // Number of functions up to degree L is sum (l+1)^2 for l <= L
+    ASSERT_EQ(Flmp::size(10), 506);
+    const size_t L = 2190;
+    ASSERT_EQ(Flmp::size(L), (L + 1) * (L + 2) * (2 * L + 3) / 6);
+}
+
+TEST(Flmp, ScalarTypes)
+{
+    const int l_max = 100;
+    double I = 109.9 * M_PI / 180;
+    Flmp ref(l_max, I, true);
+    BasicFlmp<float> single(l_max, I, true);
+    BasicFlmp<long double> extended(l_max, I, true);
+    for (int l = 0; l <= l_max; l++)
+    {
+        for (int m = 0; m <= l; m++)
+        {
+            for (int p = 0; p <= l; p++)
+            {
+                ASSERT_NEAR(single.get_Flmp(l, m, p), ref.get_Flmp(l, m, p), 1e-3);
+                ASSERT_NEAR(extended.get_Flmp(l, m, p), ref.get_Flmp(l, m, p), 1e-12);
+                ASSERT_NEAR(extended.get_dFlmp(l, m, p), ref.get_dFlmp(l, m, p), 1e-10);
+            }
+        }
+    }
+}
+
+TEST(Flmp, Engines)
+{
+    const int l_max = 150;
+    for (double I : {0.3, 109.9 * M_PI / 180, M_PI - 1e-3})
+    {
+        Flmp fft(l_max, I, true);
+        Flmp recursion(l_max, I, true, Storage(), Flmp::Recursion);
+        for (int l = 0; l <= l_max; l++)
+        {
+            for (int m = 0; m <= l; m++)
+            {
+                for (int p = 0; p <= l; p++)
+                {
+                    ASSERT_NEAR(recursion.get_Flmp(l, m, p), fft.get_Flmp(l, m, p), 1e-12);
+                    ASSERT_NEAR(recursion.get_dFlmp(l, m, p), fft.get_dFlmp(l, m, p), 1e-12 * (l + 1));
+                }
+            }
+        }
+    }
+    // The recursions keep their derivatives at the pole of the FFT engine
+    Flmp equatorial(l_max, M_PI / 2, true, Storage(), Flmp::Recursion);
+    ASSERT_TRUE(std::isfinite(equatorial.get_dFlmp(l_max, 1, l_max / 2)));
+}
+
+TEST(Flmp, Batch)
+{
+    const int l_max = 30;
+    // More inclinations than FFT lanes, so the last group is partial
+    std::vector<double> I;
+    for (int j = 0; j < 21; j++)
+    {
+        I.push_back((1 + 8.5 * j) * M_PI / 180);
+    }
+    for (Flmp::Engine engine : {Flmp::FFT, Flmp::Recursion})
+    {
+        std::vector<Flmp> tables = Flmp::batch(l_max, I, true, Storage(), engine);
+        ASSERT_EQ(tables.size(), I.size());
+        for (size_t j = 0; j < I.size(); j++)
+        {
+            Flmp ref(l_max, I[j], true, Storage(), engine);
+            ASSERT_EQ(tables[j].get_l_max(), l_max);
+            for (int l = 0; l <= l_max; l++)
+            {
+                for (int m = 0; m <= l; m++)
+                {
+                    for (int p = 0; p <= l; p++)
+                    {
+                        ASSERT_NEAR(tables[j].get_Flmp(l, m, p), ref.get_Flmp(l, m, p), 1e-14);
+                        ASSERT_NEAR(tables[j].get_dFlmp(l, m, p), ref.get_dFlmp(l, m, p), 1e-13);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(Flmp, Threads)
+{
+    const int l_max = 120;
+    const double I = 109.9 * M_PI / 180;
+    for (Flmp::Engine engine : {Flmp::FFT, Flmp::Recursion})
+    {
+        Flmp serial(l_max, I, true, Storage(), engine);
+        for (int n_threads : {2, 4, 7})
+        {
+            ThreadPool pool(n_threads);
+            Flmp parallel(l_max, I, true, Storage(), engine, &pool);
+            for (int l = 0; l <= l_max; l++)
+            {
+                for (int m = 0; m <= l; m++)
+                {
+                    for (int p = 0; p <= l; p++)
+                    {
+                        ASSERT_EQ(parallel.get_Flmp(l, m, p), serial.get_Flmp(l, m, p));
+                        ASSERT_EQ(parallel.get_dFlmp(l, m, p), serial.get_dFlmp(l, m, p));
+                    }
+                }
+            }
+        }
+    }
+    // Batches share the pool among the orders of a group of tables
+    ThreadPool pool(3);
+    std::vector<double> inclinations = {0.2, 1.1, 2.9};
+    std::vector<Flmp> tables = Flmp::batch(30, inclinations, true, Storage(), Flmp::FFT, &pool);
+    for (size_t j = 0; j < inclinations.size(); j++)
+    {
+        Flmp serial(30, inclinations[j], true);
+        for (int l = 0; l <= 30; l++)
+        {
+            for (int m = 0; m <= l; m++)
+            {
+                for (int p = 0; p <= l; p++)
+                {
+                    ASSERT_EQ(tables[j].get_Flmp(l, m, p), serial.get_Flmp(l, m, p));
+                    ASSERT_EQ(tables[j].get_dFlmp(l, m, p), serial.get_dFlmp(l, m, p));
+                }
+            }
+        }
+    }
+}
+
+#ifdef FUNCTIONS_QUADMATH
+TEST(Flmp, Quad)
+{
+    const int l_max = 60;
+    const long double I = 25 * M_PI / 180;
+    BasicFlmp<__float128> quad(l_max, I, true);
+    BasicFlmp<long double> ref(l_max, I, true);
+    for (int l = 0; l <= l_max; l++)
+    {
+        for (int m = 0; m <= l; m++)
+        {
+            for (int p = 0; p <= l; p++)
+            {
+                ASSERT_NEAR(double(quad.get_Flmp(l, m, p)), double(ref.get_Flmp(l, m, p)), 1e-15);
+                ASSERT_NEAR(double(quad.get_dFlmp(l, m, p)), double(ref.get_dFlmp(l, m, p)), 1e-13);
+            }
+        }
+    }
+}
+#endif
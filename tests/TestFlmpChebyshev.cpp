@@ -0,0 +1,64 @@
+#include <random>
+
+#include <functions>
+#include <gtest/gtest.h>
+
+TEST(FlmpChebyshev, Accuracy)
+{
+    const int l_max = 60;
+    const double I_min = 95 * M_PI / 180, I_max = 100 * M_PI / 180;
+    for (double tolerance : {1e-6, 1e-11})
+    {
+        FlmpChebyshev table(l_max, I_min, I_max, tolerance, true);
+        ASSERT_GT(table.get_n(), 1);
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> dist(I_min, I_max);
+        // Inclinations at the bounds and in between the points
+        for (double I : {I_min, I_max, dist(gen), dist(gen), dist(gen)})
+        {
+            Flmp flmp = table.evaluate(I);
+            Flmp ref(l_max, I, true, Storage(), Flmp::Recursion);
+            for (int l = 0; l <= l_max; l++)
+            {
+                for (int m = 0; m <= l; m++)
+                {
+                    for (int p = 0; p <= l; p++)
+                    {
+                        ASSERT_NEAR(flmp.get_Flmp(l, m, p), ref.get_Flmp(l, m, p), tolerance);
+                        ASSERT_NEAR(flmp.get_dFlmp(l, m, p), ref.get_dFlmp(l, m, p), tolerance);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(FlmpChebyshev, Degree)
+{
+    // Tighter targets and wider intervals need longer expansions
+    FlmpChebyshev coarse(30, 0.5, 0.6, 1e-6);
+    FlmpChebyshev fine(30, 0.5, 0.6, 1e-12);
+    FlmpChebyshev wide(30, 0.1, 3.0, 1e-12);
+    ASSERT_LT(coarse.get_n(), fine.get_n());
+    ASSERT_LT(fine.get_n(), wide.get_n());
+    // The whole range of inclinations, including the equator
+    Flmp flmp = wide.evaluate(M_PI / 2);
+    Flmp ref(30, M_PI / 2);
+    ASSERT_NEAR(flmp.get_Flmp(30, 7, 12), ref.get_Flmp(30, 7, 12), 1e-12);
+    ASSERT_EQ(flmp.get_l_max(), 30);
+}
+
+TEST(FlmpChebyshev, InPlace)
+{
+    FlmpChebyshev table(20, 1.0, 1.2, 1e-10, true);
+    Flmp flmp;
+    for (double I : {1.0, 1.05, 1.2})
+    {
+        table.evaluate(I, flmp);
+        Flmp ref = table.evaluate(I);
+        ASSERT_EQ(flmp.get_Flmp(20, 3, 4), ref.get_Flmp(20, 3, 4));
+        ASSERT_EQ(flmp.get_dFlmp(20, 3, 4), ref.get_dFlmp(20, 3, 4));
+    }
+    ASSERT_THROW(FlmpChebyshev(20, 1.2, 1.0, 1e-10), std::invalid_argument);
+    ASSERT_THROW(FlmpChebyshev(20, 1.0, 1.2, 1e-30), std::runtime_error);
+}
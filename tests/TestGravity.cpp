@@ -0,0 +1,120 @@
+#include <random>
+
+#include <functions>
+#include <gtest/gtest.h>
+
+const double GM = 3.986004415e14;
+const double R = 6378136.3;
+
+Clm random_field(int l_max)
+{
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    Clm clm(l_max);
+    clm.set_C(0, 0, 1);
+    for (int l = 2; l <= l_max; l++)
+    {
+        for (int m = 0; m <= l; m++)
+        {
+            clm.set_C(l, m, 1e-6 * dist(gen) / (l * l));
+            clm.set_S(l, m, m > 0 ? 1e-6 * dist(gen) / (l * l) : 0);
+        }
+    }
+    return clm;
+}
+
+TEST(Gravity, PointMass)
+{
+    Clm clm(0);
+    clm.set_C(0, 0, 1);
+    Gravity gravity(clm, GM, R);
+    Eigen::Vector3d r(4000e3, -5000e3, 3000e3);
+    gravity.evaluate(r, true);
+    double d = r.norm();
+    ASSERT_NEAR(gravity.get_potential() / (GM / d), 1, 1e-14);
+    ASSERT_NEAR((gravity.get_acceleration() + GM * r / pow(d, 3)).norm(), 0, 1e-14);
+    Eigen::Matrix3d T = GM * (3 * r * r.transpose() - d * d * Eigen::Matrix3d::Identity()) / pow(d, 5);
+    ASSERT_NEAR((gravity.get_gradient() - T).norm() / T.norm(), 0, 1e-14);
+}
+
+TEST(Gravity, Potential)
+{
+    // Potential matches the synthesis of the coefficients scaled by (R/r)^l
+    const int l_max = 40;
+    Clm clm = random_field(l_max);
+    Gravity gravity(clm, GM, R);
+    Eigen::Vector3d r(4000e3, -5000e3, 3000e3);
+    gravity.evaluate(r);
+    double d = r.norm();
+    Clm scaled(l_max);
+    for (int l = 0; l <= l_max; l++)
+    {
+        for (int m = 0; m <= l; m++)
+        {
+            scaled.set_C(l, m, clm.get_C(l, m) * pow(R / d, l));
+            scaled.set_S(l, m, clm.get_S(l, m) * pow(R / d, l));
+        }
+    }
+    Synthesis synthesis(scaled, acos(r[2] / d), atan2(r[1], r[0]));
+    ASSERT_NEAR(gravity.get_potential() / (GM / d * synthesis.get_V()), 1, 1e-14);
+}
+
+TEST(Gravity, Derivatives)
+{
+    // Central term removed so that tolerances apply to the harmonics
+    const int l_max = 40;
+    Clm clm = random_field(l_max);
+    clm.set_C(0, 0, 0);
+    Gravity gravity(clm, GM, R);
+    // Generic position and position over the pole
+    for (Eigen::Vector3d r : {Eigen::Vector3d(4000e3, -5000e3, 3000e3), Eigen::Vector3d(0, 0, 7000e3)})
+    {
+        gravity.evaluate(r, true);
+        Eigen::Vector3d a = gravity.get_acceleration();
+        Eigen::Matrix3d T = gravity.get_gradient();
+        const double h = 1;
+        for (int i = 0; i < 3; i++)
+        {
+            Eigen::Vector3d dr = Eigen::Vector3d::Zero();
+            dr[i] = h;
+            gravity.evaluate(r + dr);
+            double Ua = gravity.get_potential();
+            Eigen::Vector3d aa = gravity.get_acceleration();
+            gravity.evaluate(r - dr);
+            double Ub = gravity.get_potential();
+            Eigen::Vector3d ab = gravity.get_acceleration();
+            ASSERT_NEAR((Ua - Ub) / (2 * h), a[i], 1e-7 * a.norm());
+            ASSERT_NEAR(((aa - ab) / (2 * h) - T.col(i)).norm(), 0, 1e-7 * T.norm());
+        }
+        ASSERT_NEAR(T.trace(), 0, 1e-12 * T.norm());
+    }
+}
+
+TEST(Gravity, Batch)
+{
+    const int l_max = 40;
+    Clm clm = random_field(l_max);
+    Gravity gravity(clm, GM, R);
+    std::mt19937 gen(3);
+    std::normal_distribution<double> dist(0, 1);
+    std::vector<Eigen::Vector3d> accelerations;
+    // Batch sizes with and without padding, growing and shrinking workspace
+    for (int n : {13, 1, 64})
+    {
+        std::vector<Eigen::Vector3d> positions;
+        for (int k = 0; k < n; k++)
+        {
+            Eigen::Vector3d r(dist(gen), dist(gen), dist(gen));
+            positions.push_back(r.normalized() * (R + 400e3 + 1e5 * k));
+        }
+        positions[0] = Eigen::Vector3d(0, 0, -R - 500e3);
+        gravity.evaluate(positions, accelerations);
+        ASSERT_EQ(accelerations.size(), n);
+        for (int k = 0; k < n; k++)
+        {
+            gravity.evaluate(positions[k]);
+            Eigen::Vector3d a = gravity.get_acceleration();
+            ASSERT_NEAR((accelerations[k] - a).norm(), 0, 1e-14 * a.norm());
+        }
+    }
+}
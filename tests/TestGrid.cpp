@@ -0,0 +1,79 @@
+#include <random>
+
+#include <functions>
+#include <gtest/gtest.h>
+
+Clm random_clm(int l_max)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    Clm clm(l_max);
+    for (int l = 0; l <= l_max; l++)
+    {
+        for (int m = 0; m <= l; m++)
+        {
+            clm.set_C(l, m, dist(gen) / (l + 1));
+            clm.set_S(l, m, m > 0 ? dist(gen) / (l + 1) : 0);
+        }
+    }
+    return clm;
+}
+
+TEST(Grid, Weights)
+{
+    // Weights integrate sin(theta) on [0, pi]
+    for (Grid::Type type : {Grid::GaussLegendre, Grid::DriscollHealy})
+    {
+        Grid grid(50, type);
+        double sum = 0;
+        for (int i = 0; i < grid.get_n_lat(); i++)
+        {
+            sum += grid.get_weight(i);
+        }
+        ASSERT_NEAR(sum, 2, 1e-13);
+    }
+    Grid grid(50);
+    ASSERT_EQ(grid.get_n_lat(), 51);
+    ASSERT_EQ(grid.get_n_lon(), 101);
+    grid = Grid(50, Grid::DriscollHealy);
+    ASSERT_EQ(grid.get_n_lat(), 102);
+    ASSERT_EQ(grid.get_n_lon(), 204);
+}
+
+TEST(Grid, Synthesis)
+{
+    const int l_max = 40;
+    Clm clm = random_clm(l_max);
+    for (Grid::Type type : {Grid::GaussLegendre, Grid::DriscollHealy})
+    {
+        Grid grid(l_max, type);
+        Grid::Values f = grid.synthesis(clm);
+        for (int i = 0; i < grid.get_n_lat(); i += 7)
+        {
+            for (int j = 0; j < grid.get_n_lon(); j += 5)
+            {
+                Synthesis ref(clm, grid.get_theta(i), grid.get_lambda(j));
+                ASSERT_NEAR(f(i, j), ref.get_V(), 1e-12);
+            }
+        }
+    }
+}
+
+TEST(Grid, Analysis)
+{
+    const int l_max = 200;
+    Clm clm = random_clm(l_max);
+    for (Grid::Type type : {Grid::GaussLegendre, Grid::DriscollHealy})
+    {
+        Grid grid(l_max, type);
+        Clm result = grid.analysis(grid.synthesis(clm));
+        for (int l = 0; l <= l_max; l++)
+        {
+            for (int m = 0; m <= l; m++)
+            {
+                ASSERT_NEAR(result.get_C(l, m), clm.get_C(l, m), 1e-12);
+                ASSERT_NEAR(result.get_S(l, m), clm.get_S(l, m), 1e-12);
+            }
+        }
+    }
+}
@@ -18,4 +18,44 @@ TEST(Nlm, Value)
             EXPECT_NEAR(nlm.get_Nlm(l, m), sqrt((2 - d0m) * (2 * l + 1) * factorial(l - m) / factorial(l + m)), 1e-15);
         }
     }
-}
\ No newline at end of file
+}
+
+TEST(Nlm, Shared)
+{
+    auto a = Nlm::get(30);
+    auto b = Nlm::get(10);
+    ASSERT_EQ(a.get(), b.get());
+    ASSERT_GE(b->get_l_max(), 30);
+    // Growing the table keeps previously retrieved tables valid
+    auto c = Nlm::get(300);
+    ASSERT_GE(c->get_l_max(), 300);
+    ASSERT_EQ(a->get_Nlm(25, 3), c->get_Nlm(25, 3));
+}
+
+TEST(Nlm, Assignment)
+{
+    Nlm nlm;
+    nlm = Nlm(10);
+    nlm = Nlm(20);
+    Nlm other(nlm);
+    ASSERT_EQ(other.get_l_max(), 20);
+    ASSERT_EQ(other.get_Nlm(20, 20), Nlm(20).get_Nlm(20, 20));
+}
+
+TEST(Nlm, ScalarTypes)
+{
+    Nlm ref(50);
+    BasicNlm<float> single(50);
+    BasicNlm<long double> extended(50);
+    for (int l = 0; l <= 50; l++)
+    {
+        for (int m = 0; m <= l; m++)
+        {
+            const double N = ref.get_Nlm(l, m);
+            // Sectorial constants underflow single precision beyond l ~ 25
+            if (l <= 20)
+                EXPECT_NEAR(single.get_Nlm(l, m) / N, 1, 1e-5);
+            EXPECT_NEAR(extended.get_Nlm(l, m) / N, 1, 1e-14);
+        }
+    }
+}
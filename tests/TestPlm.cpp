@@ -1,7 +1,25 @@
+#include <cstdlib>
+#include <new>
+
 #include <functions>
 
 #include <gtest/gtest.h>
 
+// Count heap allocations to check allocation-free re-evaluation
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+    if (void *ptr = std::malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
 TEST(Plm, Value)
 {
     Plm plm(100, 65 * M_PI / 180);
@@ -34,4 +52,146 @@ TEST(Plm, SecondDerivatives)
     int m = 5;
     double ddPlm_num = (pa.get_dPlm_bar(l, m) - pb.get_dPlm_bar(l, m)) / (2 * dtheta);
     ASSERT_NEAR((plm.get_ddPlm_bar(l, m) - ddPlm_num) / ddPlm_num, 0, 1e-7);
-}
\ No newline at end of file
+}
+
+TEST(Plm, Degree2190)
+{
+    // Addition theorem: sum over m of squared fully-normalized ALFs is 2l+1
+    const int l_max = 2190;
+    Plm plm(l_max, 65 * M_PI / 180, true);
+    for (int l : {1000, 2000, l_max})
+    {
+        double sum = 0;
+        for (int m = 0; m <= l; m++)
+        {
+            sum += plm.get_Plm_bar(l, m) * plm.get_Plm_bar(l, m);
+        }
+        ASSERT_NEAR(sum / (2 * l + 1), 1, 1e-10);
+    }
+}
+
+TEST(Plm, UltraHighDegree)
+{
+    // Sectorial values underflow doubles for m > ~400 at 10 deg co-latitude,
+    // while terms up to m ~ 520 contribute to the degree 3000 addition theorem
+    const int l_max = 3000;
+    Plm plm(l_max, 10 * M_PI / 180);
+    double sum = 0;
+    for (int m = 0; m <= l_max; m++)
+    {
+        sum += plm.get_Plm_bar(l_max, m) * plm.get_Plm_bar(l_max, m);
+    }
+    ASSERT_NEAR(sum / (2 * l_max + 1), 1, 1e-10);
+    // Same values as the plain recursion where no underflow is possible
+    Plm low(300, 10 * M_PI / 180);
+    ASSERT_NEAR(plm.get_Plm_bar(300, 120), low.get_Plm_bar(300, 120), 1e-12);
+}
+
+
+TEST(Plm, Evaluate)
+{
+    Plm plm(100, 10 * M_PI / 180, true, true);
+    for (double theta : {5.0, 65.0, 131.0})
+    {
+        theta *= M_PI / 180;
+        size_t count = allocations;
+        plm.evaluate(theta);
+        ASSERT_EQ(allocations, count);
+        Plm ref(100, theta, true, true);
+        ASSERT_EQ(plm.get_theta(), theta);
+        for (int l = 0; l <= 100; l++)
+        {
+            for (int m = 0; m <= l; m++)
+            {
+                ASSERT_EQ(plm.get_Plm_bar(l, m), ref.get_Plm_bar(l, m));
+                ASSERT_EQ(plm.get_dPlm_bar(l, m), ref.get_dPlm_bar(l, m));
+                ASSERT_EQ(plm.get_ddPlm_bar(l, m), ref.get_ddPlm_bar(l, m));
+            }
+        }
+    }
+}
+
+TEST(Plm, Mirror)
+{
+    const double theta = 35 * M_PI / 180;
+    Plm plm(100, theta, true, true);
+    Plm ref(100, M_PI - theta, true, true);
+    for (int l = 0; l <= 100; l++)
+    {
+        for (int m = 0; m <= l; m++)
+        {
+            ASSERT_NEAR(plm.get_Plm_bar_mirror(l, m), ref.get_Plm_bar(l, m), 1e-12);
+            ASSERT_NEAR(plm.get_dPlm_bar_mirror(l, m), ref.get_dPlm_bar(l, m), 1e-10);
+            ASSERT_NEAR(plm.get_ddPlm_bar_mirror(l, m), ref.get_ddPlm_bar(l, m), 1e-8);
+        }
+    }
+    ASSERT_NEAR(plm.get_Plm_mirror(10, 3), ref.get_Plm(10, 3), 1e-9);
+}
+
+TEST(Plm, Threads)
+{
+    ThreadPool pool(4);
+    // Plain and extended range recursions
+    for (double theta : {65.0, 10.0})
+    {
+        theta *= M_PI / 180;
+        Plm serial(2500, theta, true, true);
+        Plm parallel(2500, theta, true, true, &pool);
+        for (int l = 0; l <= 2500; l++)
+        {
+            for (int m = 0; m <= l; m++)
+            {
+                ASSERT_EQ(parallel.get_Plm_bar(l, m), serial.get_Plm_bar(l, m));
+                ASSERT_EQ(parallel.get_dPlm_bar(l, m), serial.get_dPlm_bar(l, m));
+                ASSERT_EQ(parallel.get_ddPlm_bar(l, m), serial.get_ddPlm_bar(l, m));
+            }
+        }
+    }
+}
+
+TEST(Plm, ScalarTypes)
+{
+    // Single precision, with and without extended range
+    for (double theta : {65.0, 10.0})
+    {
+        theta *= M_PI / 180;
+        BasicPlm<float> single(300, theta, true);
+        Plm ref(300, theta, true);
+        for (int l = 0; l <= 300; l++)
+        {
+            for (int m = 0; m <= l; m++)
+            {
+                ASSERT_NEAR(single.get_Plm_bar(l, m), ref.get_Plm_bar(l, m), 1e-3);
+            }
+        }
+    }
+    // Extended precision tightens the addition theorem
+    const int l_max = 2190;
+    BasicPlm<long double> extended(l_max, 65 * M_PI / 180);
+    Plm ref(l_max, 65 * M_PI / 180);
+    long double sum = 0;
+    for (int m = 0; m <= l_max; m++)
+    {
+        sum += extended.get_Plm_bar(l_max, m) * extended.get_Plm_bar(l_max, m);
+        ASSERT_NEAR(extended.get_Plm_bar(l_max, m), ref.get_Plm_bar(l_max, m), 1e-11);
+    }
+    ASSERT_NEAR(sum / (2 * l_max + 1), 1, 1e-13);
+}
+
+#ifdef FUNCTIONS_QUADMATH
+TEST(Plm, Quad)
+{
+    typedef __float128 quad;
+    const int l_max = 2000;
+    const quad theta = 10 * Scalar<quad>::pi() / 180;
+    BasicPlm<quad> plm(l_max, theta);
+    BasicPlm<long double> ref(l_max, theta);
+    quad sum = 0;
+    for (int m = 0; m <= l_max; m++)
+    {
+        sum += plm.get_Plm_bar(l_max, m) * plm.get_Plm_bar(l_max, m);
+        ASSERT_NEAR(double(plm.get_Plm_bar(l_max, m)), double(ref.get_Plm_bar(l_max, m)), 1e-13);
+    }
+    ASSERT_LT(double(Scalar<quad>::fabs(sum / (2 * l_max + 1) - 1)), 1e-28);
+}
+#endif
@@ -0,0 +1,111 @@
+#include <functions>
+
+#include <gtest/gtest.h>
+
+TEST(PlmBatch, Value)
+{
+    std::vector<double> theta = {5 * M_PI / 180, 30 * M_PI / 180, 65 * M_PI / 180, 90 * M_PI / 180,
+                                 100 * M_PI / 180, 131 * M_PI / 180, 170 * M_PI / 180, 1.0, 2.0, 3.0};
+    PlmBatch batch(100, theta);
+    ASSERT_EQ(batch.get_n(), 10);
+    for (int k = 0; k < batch.get_n(); k++)
+    {
+        Plm plm(100, theta[k]);
+        for (int l = 0; l <= 100; l++)
+        {
+            for (int m = 0; m <= l; m++)
+            {
+                ASSERT_NEAR(batch.get_Plm_bar(l, m, k), plm.get_Plm_bar(l, m), 1e-12);
+            }
+        }
+    }
+    // Values retrieved from Matlab
+    ASSERT_NEAR(batch.get_Plm_bar(14, 4)[2] / Nlm(14).get_Nlm(14, 4), -9.251507461437021e+03, 1e-10);
+}
+
+TEST(PlmBatch, Derivatives)
+{
+    std::vector<double> theta = {5 * M_PI / 180, 65 * M_PI / 180, 131 * M_PI / 180};
+    PlmBatch batch(100, theta, true, true);
+    for (int k = 0; k < batch.get_n(); k++)
+    {
+        Plm plm(100, theta[k], true, true);
+        for (int l = 0; l <= 100; l++)
+        {
+            for (int m = 0; m <= l; m++)
+            {
+                ASSERT_NEAR(batch.get_dPlm_bar(l, m, k), plm.get_dPlm_bar(l, m), 1e-9);
+                ASSERT_NEAR(batch.get_ddPlm_bar(l, m, k), plm.get_ddPlm_bar(l, m), 1e-7);
+            }
+        }
+    }
+}
+
+TEST(PlmColumn, Value)
+{
+    std::vector<double> theta = {5 * M_PI / 180, 65 * M_PI / 180, 131 * M_PI / 180};
+    PlmBatch batch(60, theta, true);
+    PlmColumn column(60, theta, true);
+    for (int m = 0; m <= 60; m++)
+    {
+        if (m > 0)
+            column.next();
+        ASSERT_EQ(column.get_m(), m);
+        for (int l = m; l <= 60; l++)
+        {
+            for (int k = 0; k < column.get_n(); k++)
+            {
+                ASSERT_NEAR(column.get_Plm_bar(l)[k], batch.get_Plm_bar(l, m, k), 1e-12);
+                ASSERT_NEAR(column.get_dPlm_bar(l)[k], batch.get_dPlm_bar(l, m, k), 1e-10);
+            }
+        }
+    }
+}
+
+TEST(PlmColumn, Seek)
+{
+    // Skipping orders gives the same values as advancing one by one
+    const int l_max = 1500;
+    std::vector<double> theta = {3 * M_PI / 180, 65 * M_PI / 180};
+    PlmColumn column(l_max, theta, true);
+    PlmColumn skip(l_max, theta, true);
+    for (int m : {0, 1, 7, 8, 500, 1499, 1500})
+    {
+        while (column.get_m() < m)
+            column.next();
+        skip.seek(m);
+        ASSERT_EQ(skip.get_m(), m);
+        for (int l = m; l <= l_max; l++)
+        {
+            for (int k = 0; k < column.get_n(); k++)
+            {
+                ASSERT_EQ(skip.get_Plm_bar(l)[k], column.get_Plm_bar(l)[k]);
+                ASSERT_EQ(skip.get_dPlm_bar(l)[k], column.get_dPlm_bar(l)[k]);
+            }
+        }
+    }
+}
+
+TEST(PlmColumn, UltraHighDegree)
+{
+    // Sectorial values underflow doubles close to the pole
+    const int l_max = 3000;
+    std::vector<double> theta = {10 * M_PI / 180, 60 * M_PI / 180, 170 * M_PI / 180};
+    PlmColumn column(l_max, theta);
+    Plm plm(l_max, theta[0]);
+    std::vector<double> sum(theta.size(), 0);
+    for (int m = 0; m <= l_max; m++)
+    {
+        if (m > 0)
+            column.next();
+        for (int k = 0; k < column.get_n(); k++)
+        {
+            sum[k] += column.get_Plm_bar(l_max)[k] * column.get_Plm_bar(l_max)[k];
+        }
+        ASSERT_NEAR(column.get_Plm_bar(l_max)[0], plm.get_Plm_bar(l_max, m), 1e-10);
+    }
+    for (int k = 0; k < column.get_n(); k++)
+    {
+        ASSERT_NEAR(sum[k] / (2 * l_max + 1), 1, 1e-10);
+    }
+}
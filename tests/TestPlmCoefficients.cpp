@@ -0,0 +1,51 @@
+#include <thread>
+
+#include <functions>
+#include <gtest/gtest.h>
+
+TEST(PlmCoefficients, Value)
+{
+    PlmCoefficients coeffs(50);
+    for (int l = 2; l <= 50; l++)
+    {
+        for (int m = 0; m < l; m++)
+        {
+            EXPECT_NEAR(coeffs.get_a(l, m), sqrt((2.0 * l - 1) * (2 * l + 1) / ((l - m) * (l + m))), 1e-14);
+            EXPECT_NEAR(coeffs.get_b(l, m), sqrt((2.0 * l + 1) * (l + m - 1) * (l - m - 1) / ((l - m) * (l + m) * (2 * l - 3))), 1e-14);
+            EXPECT_NEAR(coeffs.get_f(l, m), sqrt((l * l - m * m) * (2.0 * l + 1) / (2 * l - 1)), 1e-12);
+        }
+        EXPECT_NEAR(coeffs.get_s(l), sqrt((2.0 * l + 1) / (2 * l)), 1e-15);
+    }
+    EXPECT_NEAR(coeffs.get_s(1), sqrt(3), 1e-15);
+}
+
+TEST(PlmCoefficients, Shared)
+{
+    auto a = PlmCoefficients::get(20);
+    auto b = PlmCoefficients::get(10);
+    ASSERT_EQ(a.get(), b.get());
+    ASSERT_GE(b->get_l_max(), 20);
+    // Growing the table keeps previously retrieved tables valid
+    auto c = PlmCoefficients::get(200);
+    ASSERT_GE(c->get_l_max(), 200);
+    ASSERT_EQ(a->get_a(15, 3), c->get_a(15, 3));
+}
+
+TEST(PlmCoefficients, Threads)
+{
+    std::vector<std::thread> threads;
+    std::vector<double> values(8);
+    for (int i = 0; i < 8; i++)
+    {
+        threads.emplace_back([i, &values]()
+                             { values[i] = PlmCoefficients::get(100 + 50 * i)->get_b(90, 7); });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    for (int i = 1; i < 8; i++)
+    {
+        ASSERT_EQ(values[i], values[0]);
+    }
+}
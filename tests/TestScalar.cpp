@@ -0,0 +1,43 @@
+#include <functions>
+#include <gtest/gtest.h>
+
+template <typename T> void check_scalar(double tol)
+{
+    // Powers of two are exact
+    ASSERT_EQ(Scalar<T>::pow2(0), T(1));
+    ASSERT_EQ(Scalar<T>::pow2(10), T(1024));
+    ASSERT_EQ(Scalar<T>::pow2(-3), T(0.125));
+    ASSERT_EQ(Scalar<T>::pow2(100) * Scalar<T>::pow2(-100), T(1));
+    // Functions evaluated in the precision of the type
+    const T x = T(7) / 10;
+    ASSERT_NEAR(double(Scalar<T>::cos(x)), std::cos(0.7), tol);
+    ASSERT_NEAR(double(Scalar<T>::sin(x)), std::sin(0.7), tol);
+    ASSERT_NEAR(double(Scalar<T>::acos(x)), std::acos(0.7), tol);
+    ASSERT_NEAR(double(Scalar<T>::atan2(x, -x)), std::atan2(0.7, -0.7), tol);
+    ASSERT_NEAR(double(Scalar<T>::log(x)), std::log(0.7), tol);
+    ASSERT_NEAR(double(Scalar<T>::sqrt(x)), std::sqrt(0.7), tol);
+    ASSERT_EQ(Scalar<T>::fabs(-x), x);
+    ASSERT_NEAR(double(Scalar<T>::pi()), M_PI, tol);
+    const std::complex<T> z = Scalar<T>::polar(x);
+    ASSERT_NEAR(double(z.real()), std::cos(0.7), tol);
+    ASSERT_NEAR(double(z.imag()), std::sin(0.7), tol);
+    const T c = Scalar<T>::cos(x), s = Scalar<T>::sin(x);
+    ASSERT_LE(double(Scalar<T>::fabs(c * c + s * s - 1)), tol);
+}
+
+TEST(Scalar, Float) { check_scalar<float>(1e-6); }
+
+TEST(Scalar, Double) { check_scalar<double>(1e-15); }
+
+TEST(Scalar, LongDouble) { check_scalar<long double>(1e-15); }
+
+#ifdef FUNCTIONS_QUADMATH
+TEST(Scalar, Quad)
+{
+    check_scalar<__float128>(1e-15);
+    // Quadruple precision beyond double
+    const __float128 pi = Scalar<__float128>::pi();
+    ASSERT_LT(Scalar<__float128>::fabs(Scalar<__float128>::sin(pi)), 1e-30);
+    ASSERT_EQ(Scalar<__float128>::max_exponent, 16384);
+}
+#endif
@@ -0,0 +1,56 @@
+#include <functions>
+#include <gtest/gtest.h>
+
+// Coefficients are available at compile time
+static_assert(StaticPlmCoefficients<2, double>().s[1] > 1.732, "s_1");
+static_assert(StaticPlmCoefficients<2, double>().N[0] == 1, "N_00");
+
+// Relative tolerance, as derivatives grow large next to the poles
+double tol(double x, double rel) { return rel * (1 + std::abs(x)); }
+
+TEST(StaticPlm, Value)
+{
+    for (double theta : {1.0, 65.0, 90.0, 131.0, 179.0})
+    {
+        theta *= M_PI / 180;
+        StaticPlm<20> plm(theta, true, true);
+        Plm ref(20, theta, true, true);
+        ASSERT_EQ(plm.get_l_max(), 20);
+        ASSERT_EQ(plm.get_theta(), theta);
+        for (int l = 0; l <= 20; l++)
+        {
+            for (int m = 0; m <= l; m++)
+            {
+                ASSERT_NEAR(plm.get_Plm_bar(l, m), ref.get_Plm_bar(l, m), tol(ref.get_Plm_bar(l, m), 1e-13));
+                ASSERT_NEAR(plm.get_dPlm_bar(l, m), ref.get_dPlm_bar(l, m), tol(ref.get_dPlm_bar(l, m), 1e-12));
+                ASSERT_NEAR(plm.get_ddPlm_bar(l, m), ref.get_ddPlm_bar(l, m), tol(ref.get_ddPlm_bar(l, m), 1e-10));
+                ASSERT_NEAR(plm.get_Plm(l, m) / ref.get_Plm(l, m), 1, 1e-12);
+                ASSERT_NEAR(plm.get_Plm_bar_mirror(l, m), ref.get_Plm_bar_mirror(l, m), tol(ref.get_Plm_bar_mirror(l, m), 1e-13));
+                ASSERT_NEAR(plm.get_dPlm_bar_mirror(l, m), ref.get_dPlm_bar_mirror(l, m), tol(ref.get_dPlm_bar_mirror(l, m), 1e-12));
+            }
+        }
+    }
+}
+
+TEST(StaticPlm, Evaluate)
+{
+    StaticPlm<8> plm(0.3, true);
+    plm.evaluate(1.2);
+    StaticPlm<8> ref(1.2, true);
+    for (int l = 0; l <= 8; l++)
+    {
+        for (int m = 0; m <= l; m++)
+        {
+            ASSERT_EQ(plm.get_Plm_bar(l, m), ref.get_Plm_bar(l, m));
+            ASSERT_EQ(plm.get_dPlm_bar(l, m), ref.get_dPlm_bar(l, m));
+        }
+    }
+}
+
+TEST(StaticPlm, Float)
+{
+    StaticPlm<10, float> plm(0.7f);
+    Plm ref(10, 0.7);
+    ASSERT_NEAR(plm.get_Plm_bar(10, 3), ref.get_Plm_bar(10, 3), 1e-5);
+    ASSERT_NEAR(plm.get_Plm(10, 3) / ref.get_Plm(10, 3), 1, 1e-5);
+}
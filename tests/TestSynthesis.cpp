@@ -0,0 +1,64 @@
+#include <random>
+
+#include <functions>
+#include <gtest/gtest.h>
+
+Clm random_clm(int l_max)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    Clm clm(l_max);
+    for (int l = 0; l <= l_max; l++)
+    {
+        for (int m = 0; m <= l; m++)
+        {
+            clm.set_C(l, m, dist(gen) / (l + 1));
+            clm.set_S(l, m, m > 0 ? dist(gen) / (l + 1) : 0);
+        }
+    }
+    return clm;
+}
+
+TEST(Synthesis, Value)
+{
+    const int l_max = 120;
+    Clm clm = random_clm(l_max);
+    for (double theta : {3.0, 65.0, 90.0, 131.0})
+    {
+        theta *= M_PI / 180;
+        double lambda = 0.7;
+        Plm plm(l_max, theta, true, true);
+        double V = 0, dV = 0, ddV = 0;
+        for (int l = 0; l <= l_max; l++)
+        {
+            for (int m = 0; m <= l; m++)
+            {
+                double c = clm.get_C(l, m) * cos(m * lambda) + clm.get_S(l, m) * sin(m * lambda);
+                V += plm.get_Plm_bar(l, m) * c;
+                dV += plm.get_dPlm_bar(l, m) * c;
+                ddV += plm.get_ddPlm_bar(l, m) * c;
+            }
+        }
+        Synthesis synthesis(clm, theta, lambda, true, true);
+        ASSERT_NEAR(synthesis.get_V(), V, 1e-11 * std::abs(V) + 1e-11);
+        ASSERT_NEAR(synthesis.get_dV(), dV, 1e-10 * std::abs(dV) + 1e-10);
+        ASSERT_NEAR(synthesis.get_ddV(), ddV, 1e-9 * std::abs(ddV) + 1e-9);
+        ASSERT_EQ(Synthesis(clm, theta, lambda).get_V(), synthesis.get_V());
+    }
+}
+
+TEST(Synthesis, Pole)
+{
+    // Only zonal terms survive at the pole, where derivatives stay finite
+    const int l_max = 60;
+    Clm clm = random_clm(l_max);
+    Synthesis synthesis(clm, 0, 1.2, true, true);
+    double V = 0;
+    for (int l = 0; l <= l_max; l++)
+    {
+        V += clm.get_C(l, 0) * sqrt(2 * l + 1);
+    }
+    ASSERT_NEAR(synthesis.get_V(), V, 1e-12);
+    ASSERT_TRUE(std::isfinite(synthesis.get_dV()));
+    ASSERT_TRUE(std::isfinite(synthesis.get_ddV()));
+}
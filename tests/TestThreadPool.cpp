@@ -0,0 +1,26 @@
+#include <functions>
+#include <gtest/gtest.h>
+
+TEST(ThreadPool, Run)
+{
+    ThreadPool pool(4);
+    ASSERT_EQ(pool.get_n_threads(), 4);
+    std::vector<int> count(1000, 0);
+    for (int batch = 0; batch < 10; batch++)
+    {
+        pool.run(count.size(), [&](int i) { count[i]++; });
+    }
+    for (int c : count)
+    {
+        ASSERT_EQ(c, 10);
+    }
+}
+
+TEST(ThreadPool, Serial)
+{
+    // Without workers, tasks run in order on the calling thread
+    ThreadPool pool(1);
+    std::vector<int> order;
+    pool.run(5, [&](int i) { order.push_back(i); });
+    ASSERT_EQ(order, std::vector<int>({0, 1, 2, 3, 4}));
+}
@@ -0,0 +1,42 @@
+#include <functions>
+#include <gtest/gtest.h>
+
+TEST(XNumber, Range)
+{
+    // 1e-120^5 underflows doubles but not X-numbers
+    XNumber x(1.0);
+    for (int i = 0; i < 5; i++)
+    {
+        x = x * 1e-120;
+    }
+    ASSERT_EQ(x.to_double(), 0);
+    ASSERT_EQ(x.get_i(), -2);
+    for (int i = 0; i < 5; i++)
+    {
+        x = x * 1e120;
+    }
+    ASSERT_NEAR(x.to_double(), 1, 1e-14);
+    ASSERT_EQ(x.get_i(), 0);
+}
+
+TEST(XNumber, LinearSum)
+{
+    XNumber x = XNumber(1.0) * 0x1p-400 * 0x1p-400;
+    XNumber y = XNumber(3.0) * 0x1p-400 * 0x1p-400;
+    XNumber z = XNumber::lsum2(2, x, -1, y) * 0x1p400 * 0x1p400;
+    ASSERT_EQ(z.to_double(), -1);
+    // Negligible terms in different ranges
+    z = XNumber::lsum2(1, XNumber(1.0), 1, x);
+    ASSERT_EQ(z.to_double(), 1);
+}
+
+TEST(XNumber, Product)
+{
+    XNumber x = XNumber(1.0) * 0x1p-600 * 0x1p-600;
+    XNumber y = XNumber(3.0) * 0x1p-600;
+    ASSERT_EQ((x * y).get_i(), -2);
+    ASSERT_EQ((x * y * 0x1p600 * 0x1p600 * 0x1p600).to_double(), 3);
+    // Zeros do not hide terms of other ranges
+    XNumber z = XNumber::lsum2(1, XNumber(0.0), 2, x) * 0x1p600 * 0x1p600;
+    ASSERT_EQ(z.to_double(), 2);
+}